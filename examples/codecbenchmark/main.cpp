@@ -0,0 +1,155 @@
+//============================================================================
+// Compares the compression codecs for saved states on the layouts that the
+// demo application stores in its Settings.ini file.
+//
+// Usage: CodecBenchmark [--iterations N] [Settings.ini ...]
+//
+// For each state the benchmark measures the time that convertState() needs
+// to write the state in each format with each available codec and the time
+// parseState() needs to read it back. The rows without a codec show the
+// time for serializing and parsing alone, so the difference to these rows is
+// the cost of the codec.
+//============================================================================
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "DockManager.h"
+#include "DockingState.h"
+
+using namespace ads;
+
+struct Codec
+{
+	const char* Name;
+	bool Compressed;
+	CDockManager::eCompressionCodec Value;
+};
+
+static const Codec Codecs[] =
+{
+	{"none", false, CDockManager::ZlibCodec},
+	{"zlib", true, CDockManager::ZlibCodec},
+	{"fast zlib", true, CDockManager::FastZlibCodec},
+	{"zstd", true, CDockManager::ZstdCodec},
+	{"lz4", true, CDockManager::Lz4Codec}
+};
+
+
+/**
+ * Selects the given codec for all following convertState() calls
+ */
+static void selectCodec(const Codec& c)
+{
+	CDockManager::setConfigFlag(CDockManager::XmlCompressionEnabled, c.Compressed);
+	CDockManager::setConfigParam(CDockManager::CompressionCodec, c.Value);
+}
+
+
+/**
+ * Runs all codecs in all formats on the given state and prints one row
+ * per combination
+ */
+static void benchmarkState(const QByteArray& State, int Iterations, QTextStream& out)
+{
+	const struct
+	{
+		const char* Name;
+		CDockManager::eStateFormat Value;
+	} Formats[] =
+	{
+		{"xml", CDockManager::XmlStateFormat},
+		{"binary", CDockManager::BinaryStateFormat}
+	};
+
+	for (const auto& Format : Formats)
+	{
+		// The size of the uncompressed state is the reference for the ratio
+		selectCodec(Codecs[0]);
+		const int UncompressedSize = CDockManager::convertState(State, Format.Value).size();
+		for (const auto& c : Codecs)
+		{
+			if (c.Compressed && !CDockManager::isCompressionCodecAvailable(c.Value))
+			{
+				continue;
+			}
+
+			selectCodec(c);
+			QByteArray Data;
+			QElapsedTimer Timer;
+			Timer.start();
+			for (int i = 0; i < Iterations; ++i)
+			{
+				Data = CDockManager::convertState(State, Format.Value);
+			}
+			const double SaveUs = Timer.nsecsElapsed() / 1000.0 / Iterations;
+
+			DockingState Parsed;
+			Timer.restart();
+			for (int i = 0; i < Iterations; ++i)
+			{
+				Parsed = DockingState();
+				CDockManager::parseState(Data, Parsed);
+			}
+			const double RestoreUs = Timer.nsecsElapsed() / 1000.0 / Iterations;
+
+			out << qSetFieldWidth(8) << Format.Name
+				<< qSetFieldWidth(11) << c.Name
+				<< qSetFieldWidth(10) << Data.size()
+				<< qSetFieldWidth(8) << QString::number(100.0 * Data.size() / UncompressedSize, 'f', 1)
+				<< qSetFieldWidth(12) << QString::number(SaveUs, 'f', 1)
+				<< qSetFieldWidth(12) << QString::number(RestoreUs, 'f', 1)
+				<< qSetFieldWidth(0) << '\n';
+		}
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QCommandLineParser Parser;
+	Parser.setApplicationDescription("Compares the compression codecs for saved "
+		"dock manager states. Run the demo and close it to create a Settings.ini file.");
+	Parser.addHelpOption();
+	QCommandLineOption IterationsOption("iterations", "Number of runs per measurement.", "N", "100");
+	Parser.addOption(IterationsOption);
+	Parser.addPositionalArgument("files", "Settings.ini files written by the demo.", "[Settings.ini ...]");
+	Parser.process(a);
+
+	const int Iterations = qMax(1, Parser.value(IterationsOption).toInt());
+	QStringList Files = Parser.positionalArguments();
+	if (Files.isEmpty())
+	{
+		Files << "Settings.ini";
+	}
+
+	QTextStream out(stdout);
+	out.setFieldAlignment(QTextStream::AlignRight);
+	int Result = 0;
+	for (const auto& File : Files)
+	{
+		QSettings Settings(File, QSettings::IniFormat);
+		const QByteArray State = Settings.value("mainWindow/DockingState").toByteArray();
+		DockingState Parsed;
+		if (!QFileInfo::exists(File) || !CDockManager::parseState(State, Parsed))
+		{
+			out << File << ": no valid mainWindow/DockingState found" << '\n';
+			Result = 1;
+			continue;
+		}
+
+		out << File << " - " << Iterations << " iterations" << '\n';
+		out << qSetFieldWidth(8) << "format" << qSetFieldWidth(11) << "codec"
+			<< qSetFieldWidth(10) << "bytes" << qSetFieldWidth(8) << "ratio%"
+			<< qSetFieldWidth(12) << "save us" << qSetFieldWidth(12) << "restore us"
+			<< qSetFieldWidth(0) << '\n';
+		benchmarkState(State, Iterations, out);
+		out << '\n';
+	}
+
+	return Result;
+}
@@ -9,4 +9,5 @@ SUBDIRS = \
 	deleteonclose \
 	emptydockarea \
 	dockindock \
-	configflags
+	configflags \
+	codecbenchmark
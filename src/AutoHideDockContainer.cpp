@@ -43,6 +43,7 @@
 #include "DockComponentsFactory.h"
 #include "AutoHideSideBar.h"
 #include "AutoHideTab.h"
+#include "DockingState.h"
 
 
 #include <iostream>
@@ -433,6 +434,15 @@ void CAutoHideDockContainer::saveState(QXmlStreamWriter& s)
 }
 
 
+//============================================================================
+void CAutoHideDockContainer::saveState(DockWidgetState& State)
+{
+	State.Name = d->DockWidget->objectName();
+	State.Closed = d->DockWidget->isClosed();
+	State.Size = d->isHorizontal() ? d->Size.height() : d->Size.width();
+}
+
+
 //============================================================================
 void CAutoHideDockContainer::toggleView(bool Enable)
 {
@@ -498,6 +508,10 @@ void CAutoHideDockContainer::setSize(int Size)
 	}
 
 	updateSize();
+	if (auto DockContainer = dockContainer())
+	{
+		DockContainer->markLayoutChanged();
+	}
 }
 
 
@@ -617,6 +631,10 @@ void CAutoHideDockContainer::resizeEvent(QResizeEvent* event)
 	{
         d->Size = this->size();
 		d->updateResizeHandleSizeLimitMax();
+		if (auto DockContainer = dockContainer())
+		{
+			DockContainer->markLayoutChanged();
+		}
 	}
 }
 
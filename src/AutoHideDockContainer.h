@@ -44,7 +44,7 @@ class CDockWidget;
 class CDockContainerWidget;
 class CAutoHideSideBar;
 class CDockAreaWidget;
-class CDockingStateReader;
+struct DockWidgetState;
 struct SideTabBarPrivate;
 
 /**
@@ -76,6 +76,11 @@ protected:
 	 */
 	void saveState(QXmlStreamWriter& Stream);
 
+	/**
+	 * Saves the state and size into the given dock widget state
+	 */
+	void saveState(DockWidgetState& State);
+
 public:
 	using Super = QFrame;
 
@@ -40,7 +40,7 @@
 #include "DockFocusController.h"
 #include "AutoHideDockContainer.h"
 #include "DockAreaWidget.h"
-#include "DockingStateReader.h"
+#include "DockingState.h"
 #include "AutoHideTab.h"
 
 namespace ads
@@ -63,6 +63,7 @@ struct AutoHideSideBarPrivate
     QBoxLayout* TabsLayout;
     Qt::Orientation Orientation;
     SideBarLocation SideTabArea = SideBarLocation::SideBarLeft;
+    internal::CTabExtents TabExtents;
 
     /**
      * Convenience function to check if this is a horizontal side bar
@@ -76,6 +77,11 @@ struct AutoHideSideBarPrivate
      * Called from viewport to forward event handling to this
      */
     void handleViewportEvent(QEvent* e);
+
+    /**
+     * Recalculates the cached tab extents if they are outdated
+     */
+    void updateTabExtents();
 }; // struct AutoHideSideBarPrivate
 
 
@@ -133,6 +139,35 @@ void AutoHideSideBarPrivate::handleViewportEvent(QEvent* e)
 }
 
 
+//============================================================================
+void AutoHideSideBarPrivate::updateTabExtents()
+{
+	if (TabExtents.isValid())
+	{
+		return;
+	}
+
+	TabExtents.reset(_this->count());
+	for (int i = 0; i < _this->count(); ++i)
+	{
+		auto Tab = _this->tab(i);
+		if (!Tab || Tab->isHidden())
+		{
+			continue;
+		}
+		const QRect TabRect = Tab->geometry();
+		if (isHorizontal())
+		{
+			TabExtents.append(i, TabRect.left(), TabRect.left() + TabRect.width());
+		}
+		else
+		{
+			TabExtents.append(i, TabRect.top(), TabRect.top() + TabRect.height());
+		}
+	}
+}
+
+
 //============================================================================
 CAutoHideSideBar::CAutoHideSideBar(CDockContainerWidget* parent, SideBarLocation area) :
     Super(parent),
@@ -205,7 +240,9 @@ void CAutoHideSideBar::insertTab(int Index, CAutoHideTab* SideTab)
     {
     	d->TabsLayout->insertWidget(Index, SideTab);
     }
+    d->TabExtents.invalidate();
     show();
+    d->ContainerWidget->markLayoutChanged();
 }
 
 
@@ -271,10 +308,12 @@ void CAutoHideSideBar::removeTab(CAutoHideTab* SideTab)
 {
 	SideTab->removeEventFilter(this);
     d->TabsLayout->removeWidget(SideTab);
+    d->TabExtents.invalidate();
     if (d->TabsLayout->isEmpty())
     {
     	hide();
     }
+    d->ContainerWidget->markLayoutChanged();
 }
 
 
@@ -289,11 +328,18 @@ bool CAutoHideSideBar::eventFilter(QObject *watched, QEvent *event)
 
 	switch (event->type())
 	{
+	case QEvent::Move:
+	case QEvent::Resize:
+		 d->TabExtents.invalidate();
+		 break;
+
 	case QEvent::ShowToParent:
+		 d->TabExtents.invalidate();
 		 show();
 	     break;
 
 	case QEvent::HideToParent:
+		 d->TabExtents.invalidate();
 		 if (!hasVisibleTabs())
 		 {
 			 hide();
@@ -392,10 +438,16 @@ void CAutoHideSideBar::saveState(QXmlStreamWriter& s) const
 		return;
 	}
 
-	s.writeStartElement("SideBar");
-	s.writeAttribute("Area", QString::number(sideBarLocation()));
-	s.writeAttribute("Tabs", QString::number(count()));
+	AutoHideSideBarState State;
+	saveState(State);
+	State.writeXml(s);
+}
 
+
+//============================================================================
+void CAutoHideSideBar::saveState(AutoHideSideBarState& State) const
+{
+	State.Location = sideBarLocation();
 	for (auto i = 0; i < count(); ++i)
 	{
 		auto Tab = tab(i);
@@ -404,10 +456,10 @@ void CAutoHideSideBar::saveState(QXmlStreamWriter& s) const
 			continue;
 		}
 
-		Tab->dockWidget()->autoHideDockContainer()->saveState(s);
+		DockWidgetState WidgetState;
+		Tab->dockWidget()->autoHideDockContainer()->saveState(WidgetState);
+		State.DockWidgets.append(WidgetState);
 	}
-
-	s.writeEndElement();
 }
 
 //===========================================================================
@@ -478,12 +530,11 @@ int CAutoHideSideBar::tabAt(const QPoint& Pos) const
 	}
 
 
-	for (int i = 0; i < count(); ++i)
+	d->updateTabExtents();
+	int Index = d->TabExtents.indexAt(d->isHorizontal() ? Pos.x() : Pos.y());
+	if (Index >= 0 && tab(Index)->geometry().contains(Pos))
 	{
-		if (tab(i)->geometry().contains(Pos))
-		{
-			return i;
-		}
+		return Index;
 	}
 
 	return count();
@@ -42,7 +42,7 @@ class DockContainerWidgetPrivate;
 class CDockContainerWidget;
 class CAutoHideTab;
 class CAutoHideDockContainer;
-class CDockingStateReader;
+struct AutoHideSideBarState;
 
 /**
  * Side tab bar widget that is shown at the edges of a dock container.
@@ -76,6 +76,11 @@ protected:
 	 */
 	void saveState(QXmlStreamWriter& Stream) const;
 
+	/**
+	 * Saves the state into the given side bar state
+	 */
+	void saveState(AutoHideSideBarState& State) const;
+
 	/**
 	 * Inserts the given dock widget tab at the given position.
 	 * An Index value of -1 appends the side tab at the end.
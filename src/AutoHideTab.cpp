@@ -134,7 +134,7 @@ struct AutoHideTabPrivate
 	template <typename T>
 	IFloatingWidget* createFloatingWidget(T* Widget)
 	{
-		auto w = new CFloatingDragPreview(Widget);
+		auto w = CFloatingDragPreview::create(Widget);
 		_this->connect(w, &CFloatingDragPreview::draggingCanceled, [=]()
 		{
 			DragState = DraggingInactive;
@@ -266,7 +266,7 @@ CAutoHideTab::~CAutoHideTab()
 //============================================================================
 void CAutoHideTab::updateStyle()
 {
-    internal::repolishStyle(this, internal::RepolishDirectChildren);
+    internal::scheduleRepolishStyle(this, internal::RepolishDirectChildren);
 	update();
 }
 
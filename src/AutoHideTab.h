@@ -93,7 +93,8 @@ public:
 	virtual ~CAutoHideTab();
 
 	/**
-	 * Update stylesheet style if a property changes
+	 * Update stylesheet style if a property changes.
+	 * The update is deferred and executed once before the next paint
 	 */
 	void updateStyle();
 
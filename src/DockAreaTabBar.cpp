@@ -60,12 +60,18 @@ struct DockAreaTabBarPrivate
 	QWidget* TabsContainerWidget;
 	QBoxLayout* TabsLayout;
 	int CurrentIndex = -1;
+	internal::CTabExtents TabExtents;
 
 	/**
 	 * Private data constructor
 	 */
 	DockAreaTabBarPrivate(CDockAreaTabBar* _public);
 
+	/**
+	 * Recalculates the cached tab extents if they are outdated
+	 */
+	void updateTabExtents();
+
 	/**
 	 * Update tabs after current index changed or when tabs are removed.
 	 * The function reassigns the stylesheet to update the tabs
@@ -92,6 +98,28 @@ DockAreaTabBarPrivate::DockAreaTabBarPrivate(CDockAreaTabBar* _public) :
 }
 
 
+//============================================================================
+void DockAreaTabBarPrivate::updateTabExtents()
+{
+	if (TabExtents.isValid())
+	{
+		return;
+	}
+
+	TabExtents.reset(_this->count());
+	for (int i = 0; i < _this->count(); ++i)
+	{
+		auto Tab = _this->tab(i);
+		if (Tab->isHidden())
+		{
+			continue;
+		}
+		const QRect TabRect = Tab->geometry();
+		TabExtents.append(i, TabRect.left(), TabRect.left() + TabRect.width());
+	}
+}
+
+
 //============================================================================
 void DockAreaTabBarPrivate::updateTabs()
 {
@@ -207,6 +235,7 @@ int CDockAreaTabBar::count() const
 void CDockAreaTabBar::insertTab(int Index, CDockWidgetTab* Tab)
 {
 	d->TabsLayout->insertWidget(Index, Tab);
+	d->TabExtents.invalidate();
 	connect(Tab, SIGNAL(clicked()), this, SLOT(onTabClicked()));
 	connect(Tab, SIGNAL(closeRequested()), this, SLOT(onTabCloseRequested()));
 	connect(Tab, SIGNAL(closeOtherTabsRequested()), this, SLOT(onCloseOtherTabsRequested()));
@@ -275,6 +304,7 @@ void CDockAreaTabBar::removeTab(CDockWidgetTab* Tab)
 
 	Q_EMIT removingTab(RemoveIndex);
 	d->TabsLayout->removeWidget(Tab);
+	d->TabExtents.invalidate();
 	Tab->disconnect(this);
 	Tab->removeEventFilter(this);
     ADS_PRINT("NewCurrentIndex " << NewCurrentIndex);
@@ -415,6 +445,7 @@ void CDockAreaTabBar::onTabWidgetMoved(const QPoint& GlobalPos)
 	{
 		d->TabsLayout->removeWidget(MovingTab);
 		d->TabsLayout->insertWidget(toIndex, MovingTab);
+		d->TabExtents.invalidate();
         ADS_PRINT("tabMoved from " << fromIndex << " to " << toIndex);
 		Q_EMIT tabMoved(fromIndex, toIndex);
 		setCurrentIndex(toIndex);
@@ -455,12 +486,19 @@ bool CDockAreaTabBar::eventFilter(QObject *watched, QEvent *event)
 
 	switch (event->type())
 	{
+	case QEvent::Move:
+	case QEvent::Resize:
+		 d->TabExtents.invalidate();
+		 break;
+
 	case QEvent::Hide:
+		 d->TabExtents.invalidate();
 		 Q_EMIT tabClosed(d->TabsLayout->indexOf(Tab));
 		 updateGeometry();
 		 break;
 
 	case QEvent::Show:
+		 d->TabExtents.invalidate();
 		 Q_EMIT tabOpened(d->TabsLayout->indexOf(Tab));
 		 updateGeometry();
 		 break;
@@ -519,12 +557,11 @@ int CDockAreaTabBar::tabAt(const QPoint& Pos) const
 		return -1;
 	}
 
-	for (int i = 0; i < count(); ++i)
+	d->updateTabExtents();
+	int Index = d->TabExtents.indexAt(Pos.x());
+	if (Index >= 0 && tab(Index)->geometry().contains(Pos))
 	{
-		if (tab(i)->geometry().contains(Pos))
-		{
-			return i;
-		}
+		return Index;
 	}
 
 	return count();
@@ -39,6 +39,8 @@
 #include <QDebug>
 #include <QPointer>
 #include <QApplication>
+#include <QTimer>
+#include <QHash>
 
 #include "DockAreaTitleBar_p.h"
 #include "ads_globals.h"
@@ -77,7 +79,9 @@ struct DockAreaTitleBarPrivate
 	CDockAreaTabBar* TabBar;
 	CElidingLabel* AutoHideTitleLabel = nullptr;
 	bool MenuOutdated = true;
+	bool TabsMenuButtonUpdatePending = false;
 	QMenu* TabsMenu;
+	QHash<CDockWidgetTab*, QPointer<QAction>> TabsMenuActions;
 	QList<tTitleBarButton*> DockWidgetActionsButtons;
 
 	QPoint DragStartMousePos;
@@ -106,6 +110,27 @@ struct DockAreaTitleBarPrivate
 	 */
 	void createTabBar();
 
+	/**
+	 * Brings the tabs menu in sync with the open tabs of the tab bar.
+	 * Existing actions are reused, so after inserting, removing or moving
+	 * a single tab, only a single menu entry is created, deleted or moved
+	 */
+	void updateTabsMenu();
+
+	/**
+	 * Schedules an update of the tabs menu button visibility for the
+	 * DockAreaDynamicTabsMenuButtonVisibility feature. Multiple requests
+	 * within one event loop cycle - e.g. if the elided state of many tabs
+	 * changes during a resize - are handled by a single update
+	 */
+	void requestTabsMenuButtonUpdate();
+
+	/**
+	 * Shows the tabs menu button, if there is an open tab with an elided
+	 * title
+	 */
+	void updateTabsMenuButtonVisibility();
+
 	/**
 	 * Convenience function for DockManager access
 	 */
@@ -272,7 +297,112 @@ void DockAreaTitleBarPrivate::createTabBar()
 	_this->connect(TabBar, SIGNAL(tabMoved(int, int)), SLOT(markTabsMenuOutdated()));
 	_this->connect(TabBar, SIGNAL(currentChanged(int)), SLOT(onCurrentTabChanged(int)));
 	_this->connect(TabBar, SIGNAL(tabBarClicked(int)), SIGNAL(tabBarClicked(int)));
-	_this->connect(TabBar, SIGNAL(elidedChanged(bool)), SLOT(markTabsMenuOutdated()));
+	_this->connect(TabBar, &CDockAreaTabBar::elidedChanged, _this, [this]()
+	{
+		requestTabsMenuButtonUpdate();
+	});
+}
+
+
+//============================================================================
+void DockAreaTitleBarPrivate::updateTabsMenu()
+{
+	QMenu* Menu = TabsMenuButton->menu();
+	QList<QAction*> MenuActions = Menu->actions();
+	QHash<CDockWidgetTab*, QPointer<QAction>> Actions;
+	Actions.reserve(TabBar->count());
+	int MenuIndex = 0;
+	for (int i = 0; i < TabBar->count(); ++i)
+	{
+		if (!TabBar->isTabOpen(i))
+		{
+			continue;
+		}
+
+		auto Tab = TabBar->tab(i);
+		QAction* Action = TabsMenuActions.take(Tab);
+		if (!Action)
+		{
+			Action = new QAction(Tab->icon(), Tab->text(), Menu);
+		}
+		else
+		{
+			Action->setText(Tab->text());
+			if (Action->icon().cacheKey() != Tab->icon().cacheKey())
+			{
+				Action->setIcon(Tab->icon());
+			}
+		}
+		if (Action->toolTip() != Tab->toolTip())
+		{
+			internal::setToolTip(Action, Tab->toolTip());
+		}
+		Action->setData(i);
+
+		// Only actions that are not at the right position in the menu
+		// need to be inserted or moved
+		QAction* Before = MenuActions.value(MenuIndex);
+		if (Before != Action)
+		{
+			Menu->insertAction(Before, Action);
+			MenuActions.removeOne(Action);
+			MenuActions.insert(MenuIndex, Action);
+		}
+		Actions.insert(Tab, Action);
+		++MenuIndex;
+	}
+
+	// The remaining actions belong to tabs that have been closed or removed
+	for (const auto& Action : TabsMenuActions)
+	{
+		delete Action.data();
+	}
+	TabsMenuActions = Actions;
+}
+
+
+//============================================================================
+void DockAreaTitleBarPrivate::requestTabsMenuButtonUpdate()
+{
+	if (TabsMenuButtonUpdatePending
+	 || !testConfigFlag(CDockManager::DockAreaDynamicTabsMenuButtonVisibility))
+	{
+		return;
+	}
+
+	TabsMenuButtonUpdatePending = true;
+	QTimer::singleShot(0, _this, [this]()
+	{
+		TabsMenuButtonUpdatePending = false;
+		updateTabsMenuButtonVisibility();
+	});
+}
+
+
+//============================================================================
+void DockAreaTitleBarPrivate::updateTabsMenuButtonVisibility()
+{
+	if (!TabsMenuButton)
+	{
+		return;
+	}
+
+	bool hasElidedTabTitle = false;
+	for (int i = 0; i < TabBar->count(); ++i)
+	{
+		if (!TabBar->isTabOpen(i))
+		{
+			continue;
+		}
+		CDockWidgetTab* Tab = TabBar->tab(i);
+		if(Tab->isTitleElided())
+		{
+			hasElidedTabTitle = true;
+			break;
+		}
+	}
+	bool visible = (hasElidedTabTitle && (TabBar->count() > 1));
+	TabsMenuButton->setVisible(visible);
 }
 
 
@@ -294,7 +424,7 @@ IFloatingWidget* DockAreaTitleBarPrivate::makeAreaFloating(const QPoint& Offset,
 	}
 	else
 	{
-		auto w = new CFloatingDragPreview(DockArea);
+		auto w = CFloatingDragPreview::create(DockArea);
 		QObject::connect(w, &CFloatingDragPreview::draggingCanceled, [=]()
 		{
 			this->DragState = DraggingInactive;
@@ -380,25 +510,7 @@ CDockAreaTabBar* CDockAreaTitleBar::tabBar() const
 //============================================================================
 void CDockAreaTitleBar::markTabsMenuOutdated()
 {
-	if(DockAreaTitleBarPrivate::testConfigFlag(CDockManager::DockAreaDynamicTabsMenuButtonVisibility))
-	{
-		bool hasElidedTabTitle = false;
-		for (int i = 0; i < d->TabBar->count(); ++i)
-		{
-			if (!d->TabBar->isTabOpen(i))
-			{
-				continue;
-			}
-			CDockWidgetTab* Tab = d->TabBar->tab(i);
-			if(Tab->isTitleElided())
-			{
-				hasElidedTabTitle = true;
-				break;
-			}
-		}
-		bool visible = (hasElidedTabTitle && (d->TabBar->count() > 1));
-		QMetaObject::invokeMethod(d->TabsMenuButton, "setVisible", Qt::QueuedConnection, Q_ARG(bool, visible));
-	}
+	d->requestTabsMenuButtonUpdate();
 	d->MenuOutdated = true;
 }
 
@@ -410,20 +522,7 @@ void CDockAreaTitleBar::onTabsMenuAboutToShow()
 		return;
 	}
 
-	QMenu* menu = d->TabsMenuButton->menu();
-	menu->clear();
-	for (int i = 0; i < d->TabBar->count(); ++i)
-	{
-		if (!d->TabBar->isTabOpen(i))
-		{
-			continue;
-		}
-		auto Tab = d->TabBar->tab(i);
-		QAction* Action = menu->addAction(Tab->icon(), Tab->text());
-		internal::setToolTip(Action, Tab->toolTip());
-		Action->setData(i);
-	}
-
+	d->updateTabsMenu();
 	d->MenuOutdated = false;
 }
 
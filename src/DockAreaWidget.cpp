@@ -53,7 +53,7 @@
 #include "DockAreaTitleBar.h"
 #include "DockComponentsFactory.h"
 #include "DockWidgetTab.h"
-#include "DockingStateReader.h"
+#include "DockingState.h"
 
 
 namespace ads
@@ -339,6 +339,18 @@ struct DockAreaWidgetPrivate
 			MinSizeHint.setWidth(qMax(MinSizeHint.width(), Widget->minimumSizeHint().width()));
 		}
 	}
+
+	/**
+	 * Marks the layout of the dock container of this area as changed
+	 */
+	void markLayoutChanged()
+	{
+		auto DockContainer = _this->dockContainer();
+		if (DockContainer)
+		{
+			DockContainer->markLayoutChanged();
+		}
+	}
 };
 
 
@@ -541,6 +553,7 @@ void CDockAreaWidget::insertDockWidget(int index, CDockWidget* DockWidget,
 	}
 	d->updateTitleBarButtonStates();
     updateTitleBarVisibility();
+    d->markLayoutChanged();
 }
 
 
@@ -565,13 +578,9 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
     auto CurrentDockWidget = currentDockWidget();
   	auto NextOpenDockWidget = (DockWidget == CurrentDockWidget) ? nextOpenDockWidget(DockWidget) : nullptr;
 
-	d->ContentsLayout->removeWidget(DockWidget);
-	auto TabWidget = DockWidget->tabWidget();
-	TabWidget->hide();
-	d->tabBar()->removeTab(TabWidget);
-	TabWidget->setParent(DockWidget);
-	DockWidget->setDockArea(nullptr);
+	releaseDockWidget(DockWidget);
 	CDockContainerWidget* DockContainer = dockContainer();
+	DockContainer->markLayoutChanged();
 	if (NextOpenDockWidget)
 	{
 		setCurrentDockWidget(NextOpenDockWidget);
@@ -580,7 +589,10 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
 	{
         ADS_PRINT("Dock Area empty");
 		DockContainer->removeDockArea(this);
-		this->deleteLater();
+		if (!d->DockManager || !d->DockManager->recycleDockArea(this))
+		{
+			this->deleteLater();
+		}
 		if(DockContainer->dockAreaCount() == 0)
 		{
 			if(CFloatingDockContainer*  FloatingDockContainer = DockContainer->floatingWidget())
@@ -600,7 +612,6 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
 
 	d->updateTitleBarButtonStates();
 	updateTitleBarVisibility();
-	d->updateMinimumSizeHint();
 	auto TopLevelDockWidget = DockContainer->topLevelDockWidget();
 	if (TopLevelDockWidget)
 	{
@@ -613,6 +624,19 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
 }
 
 
+//============================================================================
+void CDockAreaWidget::releaseDockWidget(CDockWidget* DockWidget)
+{
+	d->ContentsLayout->removeWidget(DockWidget);
+	auto TabWidget = DockWidget->tabWidget();
+	TabWidget->hide();
+	d->tabBar()->removeTab(TabWidget);
+	TabWidget->setParent(DockWidget);
+	DockWidget->setDockArea(nullptr);
+	d->updateMinimumSizeHint();
+}
+
+
 //============================================================================
 void CDockAreaWidget::hideAreaWithNoVisibleContent()
 {
@@ -719,6 +743,7 @@ void CDockAreaWidget::setCurrentIndex(int index)
     TabBar->setCurrentIndex(index);
 	d->ContentsLayout->setCurrentIndex(index);
 	d->ContentsLayout->currentWidget()->show();
+	d->markLayoutChanged();
 	Q_EMIT currentChanged(index);
 }
 
@@ -836,6 +861,7 @@ void CDockAreaWidget::reorderDockWidget(int fromIndex, int toIndex)
 	d->ContentsLayout->removeWidget(Widget);
 	d->ContentsLayout->insertWidget(toIndex, Widget);
 	setCurrentIndex(toIndex);
+	d->markLayoutChanged();
 }
 
 
@@ -907,6 +933,27 @@ void CDockAreaWidget::updateTitleBarButtonVisibility(bool IsTopLevel) const
 }
 
 
+//============================================================================
+void CDockAreaWidget::resetForReuse()
+{
+	d->AllowedAreas = DefaultAllowedAreas;
+	setDockAreaFlags(DefaultFlags);
+	d->MinSizeHint = QSize();
+	setProperty("currentDockWidget", QVariant());
+	d->TitleBar->autoHideTitleLabel()->setText(QString());
+
+	// The focus controller skips the repolishing if the focused property does
+	// not change, so a reused dock area must not keep the focus style of its
+	// previous use
+	if (property("focused").toBool())
+	{
+		setProperty("focused", false);
+		internal::repolishStyle(this);
+		internal::repolishStyle(d->TitleBar);
+	}
+}
+
+
 //============================================================================
 void CDockAreaWidget::updateTitleBarButtonsToolTips()
 {
@@ -920,88 +967,49 @@ void CDockAreaWidget::updateTitleBarButtonsToolTips()
 //============================================================================
 void CDockAreaWidget::saveState(QXmlStreamWriter& s) const
 {
-	s.writeStartElement("Area");
-	s.writeAttribute("Tabs", QString::number(d->ContentsLayout->count()));
-	auto CurrentDockWidget = currentDockWidget();
-	QString Name = CurrentDockWidget ? CurrentDockWidget->objectName() : "";
-	s.writeAttribute("Current", Name);
+	DockAreaState State;
+	saveState(State);
+	State.writeXml(s);
+}
 
-	if (d->AllowedAreas != DefaultAllowedAreas)
-	{
-		s.writeAttribute("AllowedAreas", QString::number(d->AllowedAreas, 16));
-	}
 
-	if (d->Flags != DefaultFlags)
-	{
-		s.writeAttribute("Flags", QString::number(d->Flags, 16));
-	}
+//============================================================================
+void CDockAreaWidget::saveState(DockAreaState& State) const
+{
+	auto CurrentDockWidget = currentDockWidget();
+	State.CurrentDockWidget = CurrentDockWidget ? CurrentDockWidget->objectName() : "";
+	State.AllowedAreas = d->AllowedAreas;
+	State.Flags = d->Flags;
     ADS_PRINT("CDockAreaWidget::saveState TabCount: " << d->ContentsLayout->count()
-            << " Current: " << Name);
+            << " Current: " << State.CurrentDockWidget);
+	State.DockWidgets.reserve(d->ContentsLayout->count());
 	for (int i = 0; i < d->ContentsLayout->count(); ++i)
 	{
-		dockWidget(i)->saveState(s);
+		auto DockWidget = dockWidget(i);
+		DockWidgetState WidgetState;
+		WidgetState.Name = DockWidget->objectName();
+		WidgetState.Closed = DockWidget->isClosed();
+		State.DockWidgets.append(WidgetState);
 	}
-	s.writeEndElement();
 }
 
 
 //============================================================================
-bool CDockAreaWidget::restoreState(CDockingStateReader& s, CDockAreaWidget*& CreatedWidget,
-		bool Testing, CDockContainerWidget* Container)
+CDockAreaWidget* CDockAreaWidget::restoreState(const DockAreaState& State,
+	CDockContainerWidget* Container)
 {
-	bool Ok;
-#ifdef ADS_DEBUG_PRINT
-	int Tabs = s.attributes().value("Tabs").toInt(&Ok);
-	if (!Ok)
-	{
-		return false;
-	}
-#endif
-
-	QString CurrentDockWidget = s.attributes().value("Current").toString();
-    ADS_PRINT("Restore NodeDockArea Tabs: " << Tabs << " Current: "
-            << CurrentDockWidget);
+    ADS_PRINT("Restore NodeDockArea Tabs: " << State.DockWidgets.count()
+    	<< " Current: " << State.CurrentDockWidget);
 
     auto DockManager = Container->dockManager();
-	CDockAreaWidget* DockArea = nullptr;
-	if (!Testing)
-	{
-		DockArea = new CDockAreaWidget(DockManager, Container);
-		const auto AllowedAreasAttribute = s.attributes().value("AllowedAreas");
-		if (!AllowedAreasAttribute.isEmpty())
-		{
-			DockArea->setAllowedAreas((DockWidgetArea)AllowedAreasAttribute.toInt(nullptr, 16));
-		}
-
-		const auto FlagsAttribute = s.attributes().value("Flags");
-		if (!FlagsAttribute.isEmpty())
-		{
-			DockArea->setDockAreaFlags((CDockAreaWidget::DockAreaFlags)FlagsAttribute.toInt(nullptr, 16));
-		}
-	}
+	CDockAreaWidget* DockArea = DockManager->createDockArea(Container);
+	DockArea->setAllowedAreas((DockWidgetArea)State.AllowedAreas);
+	DockArea->setDockAreaFlags((CDockAreaWidget::DockAreaFlags)State.Flags);
 
-	while (s.readNextStartElement())
+	for (const auto& WidgetState : State.DockWidgets)
 	{
-        if (s.name() != QLatin1String("Widget"))
-		{
-			continue;
-		}
-
-		auto ObjectName = s.attributes().value("Name");
-		if (ObjectName.isEmpty())
-		{
-			return false;
-		}
-
-		bool Closed = s.attributes().value("Closed").toInt(&Ok);
-		if (!Ok)
-		{
-			return false;
-		}
-
-		s.skipCurrentElement();
-		CDockWidget* DockWidget = DockManager->findDockWidget(ObjectName.toString());
-		if (!DockWidget || Testing)
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Name);
+		if (!DockWidget)
 		{
 			continue;
 		}
@@ -1016,29 +1024,24 @@ bool CDockAreaWidget::restoreState(CDockingStateReader& s, CDockAreaWidget*& Cre
 		// of the dock areas during application startup
 		DockArea->hide();
         DockArea->addDockWidget(DockWidget);
+        bool Closed = WidgetState.Closed;
 		DockWidget->setToggleViewActionChecked(!Closed);
 		DockWidget->setClosedState(Closed);
 		DockWidget->setProperty(internal::ClosedProperty, Closed);
 		DockWidget->setProperty(internal::DirtyProperty, false);
 	}
 
-	if (Testing)
-	{
-		return true;
-	}
-
 	if (!DockArea->dockWidgetsCount())
 	{
-		delete DockArea;
-		DockArea = nullptr;
-	}
-	else
-	{
-		DockArea->setProperty("currentDockWidget", CurrentDockWidget);
+		if (!DockManager->recycleDockArea(DockArea))
+		{
+			delete DockArea;
+		}
+		return nullptr;
 	}
 
-	CreatedWidget = DockArea;
-	return true;
+	DockArea->setProperty("currentDockWidget", State.CurrentDockWidget);
+	return DockArea;
 }
 
 
@@ -1135,7 +1138,24 @@ void CDockAreaWidget::toggleView(bool Open)
 //============================================================================
 void CDockAreaWidget::setVisible(bool Visible)
 {
+	bool WasHidden = isHidden();
 	Super::setVisible(Visible);
+	if (WasHidden != isHidden())
+	{
+		auto Splitter = qobject_cast<CDockSplitter*>(parentWidget());
+		if (Splitter)
+		{
+			Splitter->onContentVisibilityChanged(this, WasHidden);
+		}
+
+		auto Container = dockContainer();
+		if (Container)
+		{
+			Container->invalidateVisibleDockAreaCount();
+			Container->markLayoutChanged();
+		}
+	}
+
 	if (d->UpdateTitleBarButtons)
 	{
 		d->updateTitleBarButtonStates();
@@ -1147,6 +1167,7 @@ void CDockAreaWidget::setVisible(bool Visible)
 void CDockAreaWidget::setAllowedAreas(DockWidgetAreas areas)
 {
 	d->AllowedAreas = areas;
+	d->markLayoutChanged();
 }
 
 
@@ -1169,6 +1190,7 @@ void CDockAreaWidget::setDockAreaFlags(DockAreaFlags Flags)
 {
 	auto ChangedFlags = d->Flags ^ Flags;
 	d->Flags = Flags;
+	d->markLayoutChanged();
 	if (ChangedFlags.testFlag(HideSingleWidgetTitleBar))
 	{
 		updateTitleBarVisibility();
@@ -1474,20 +1496,34 @@ void CDockAreaWidget::setFloating()
 }
 
 
-#ifdef Q_OS_WIN
 //============================================================================
 bool CDockAreaWidget::event(QEvent *e)
 {
     switch (e->type())
     {
+#ifdef Q_OS_WIN
     case QEvent::PlatformSurface: return true;
+#endif
+
+    case QEvent::Move:
+    case QEvent::Resize:
+    case QEvent::Show:
+    case QEvent::Hide:
+        {
+            auto Container = dockContainer();
+            if (Container)
+            {
+                Container->invalidateDockAreaIndex();
+            }
+        }
+        break;
+
     default:
         break;
     }
 
     return Super::event(e);
 }
-#endif
 
 } // namespace ads
 
@@ -46,7 +46,7 @@ class CDockManager;
 class CDockContainerWidget;
 class DockContainerWidgetPrivate;
 class CDockAreaTitleBar;
-class CDockingStateReader;
+struct DockAreaState;
 class CDockSplitter;
 
 
@@ -98,15 +98,15 @@ private Q_SLOTS:
 
 protected:
 
-#ifdef Q_OS_WIN
 	/**
-	 * Reimplements QWidget::event to handle QEvent::PlatformSurface
+	 * Reimplements QWidget::event to invalidate the dock area index of the
+	 * dock container, if this dock area is moved, resized, shown or hidden.
+	 * On Windows the function handles QEvent::PlatformSurface.
 	 * This is here to fix issue #294 Tab refresh problem with a QGLWidget
 	 * that exists since Qt version 5.12.7. So this function is here to
 	 * work around a Qt issue.
 	 */
 	virtual bool event(QEvent *event) override;
-#endif
 
 	/**
 	 * Inserts a dock widget into dock area.
@@ -128,6 +128,15 @@ protected:
 	 */
 	void removeDockWidget(CDockWidget* DockWidget);
 
+	/**
+	 * Removes the given dock widget from the tab bar and the contents of
+	 * this dock area. Unlike removeDockWidget(), the function neither
+	 * activates another dock widget nor removes this dock area from its
+	 * container, if it becomes empty. The dock container uses this function
+	 * to move dock widgets, if it updates its layout in place.
+	 */
+	void releaseDockWidget(CDockWidget* DockWidget);
+
 	/**
 	 * Called from dock widget if it is opened or closed
 	 */
@@ -174,6 +183,13 @@ protected:
 	 */
 	void updateTitleBarButtonVisibility(bool IsTopLevel) const;
 
+	/**
+	 * Resets the allowed areas, the flags, the focus style and the cached
+	 * state of this empty dock area, before the dock manager moves it into
+	 * the widget pool for later reuse
+	 */
+	void resetForReuse();
+
 protected Q_SLOTS:
 	void toggleView(bool Open);
 
@@ -308,12 +324,17 @@ public:
 	 */
 	void saveState(QXmlStreamWriter& Stream) const;
 
+	/**
+	 * Saves the state into the given dock area state
+	 */
+	void saveState(DockAreaState& State) const;
+
     /**
-	 * Restores a dock area.
-	 * \see restoreChildNodes() for details
+	 * Creates a dock area from the given dock area state.
+	 * Returns 0, if none of the dock widgets in the state could be found
 	 */
-    static bool restoreState(CDockingStateReader& Stream, CDockAreaWidget*& CreatedWidget,
-		bool Testing, CDockContainerWidget* ParentContainer);
+    static CDockAreaWidget* restoreState(const DockAreaState& State,
+		CDockContainerWidget* ParentContainer);
 
 	/**
 	 * This functions returns the dock widget features of all dock widget in
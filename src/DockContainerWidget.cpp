@@ -34,6 +34,8 @@
 #include <QList>
 #include <QGridLayout>
 #include <QPointer>
+#include <QHash>
+#include <QSet>
 #include <QVariant>
 #include <QDebug>
 #include <QXmlStreamWriter>
@@ -47,7 +49,7 @@
 #include "DockManager.h"
 #include "DockAreaWidget.h"
 #include "DockWidget.h"
-#include "DockingStateReader.h"
+#include "DockingState.h"
 #include "FloatingDockContainer.h"
 #include "DockOverlay.h"
 #include "ads_globals.h"
@@ -62,36 +64,11 @@
 #include <functional>
 #include <iostream>
 
-#if QT_VERSION < 0x050900
-
-inline char toHexLower(uint value)
-{
-    return "0123456789abcdef"[value & 0xF];
-}
-
-QByteArray qByteArrayToHex(const QByteArray& src, char separator)
-{
-    if(src.size() == 0)
-        return QByteArray();
-
-    const int length = separator ? (src.size() * 3 - 1) : (src.size() * 2);
-    QByteArray hex(length, Qt::Uninitialized);
-    char *hexData = hex.data();
-    const uchar *data = reinterpret_cast<const uchar *>(src.data());
-    for (int i = 0, o = 0; i < src.size(); ++i) {
-        hexData[o++] = toHexLower(data[i] >> 4);
-        hexData[o++] = toHexLower(data[i] & 0xf);
-
-        if ((separator) && (o < length))
-            hexData[o++] = separator;
-    }
-    return hex;
-}
-#endif
-
 namespace ads
 {
 static unsigned int zOrderCounter = 0;
+static quint64 layoutGenerationCounter = 0;
+static const int DockAreaGridSize = 16; ///< number of rows and columns of the dock area index grid
 
 enum eDropMode
 {
@@ -132,6 +109,27 @@ static void insertWidgetIntoSplitter(QSplitter* Splitter, QWidget* widget, bool
 	}
 }
 
+/**
+ * A splitter of a layout that is updated in place
+ */
+struct SplitterUpdate
+{
+	CDockSplitter* Splitter = nullptr;
+	int ChildCount = 0; ///< number of child widgets in the updated layout
+	const DockLayoutNode* Node = nullptr; ///< 0 for a splitter that wraps a single root dock area
+};
+
+/**
+ * Collects the widgets of a layout while it is updated in place
+ */
+struct LayoutUpdate
+{
+	QList<CDockAreaWidget*> DockAreas; ///< dock areas of the updated layout in pre-order
+	QSet<CDockAreaWidget*> CreatedDockAreas;
+	QSet<CDockSplitter*> OldSplitters; ///< splitters of the old layout that have not been reused yet
+	QVector<SplitterUpdate> Splitters; ///< splitters of the updated layout, children before parents
+};
+
 /**
  * Private data class of CDockContainerWidget class (pimpl)
  */
@@ -153,6 +151,13 @@ public:
 	QTimer DelayedAutoHideTimer;
 	CAutoHideTab* DelayedAutoHideTab;
 	bool DelayedAutoHideShow = false;
+	quint64 LayoutGeneration = 0;
+	QVector<QPair<QRect, QPointer<CDockAreaWidget>>> IndexedDockAreas; ///< visible dock areas in container coordinates
+	QVector<QVector<int>> DockAreaGrid; ///< indexes into IndexedDockAreas for each grid cell
+	QSize DockAreaGridCellSize;
+	bool DockAreaIndexValid = false; ///< false, if the dock area index needs to be rebuilt
+	QHash<int, CDockAreaWidget*> UpdatedDockAreas; ///< dock areas assigned to the area nodes by prepareStateUpdate()
+	QSet<CDockAreaWidget*> ChangedDockAreas; ///< dock areas that lost dock widgets in prepareStateUpdate()
 
 	/**
 	 * Private data constructor
@@ -235,45 +240,104 @@ public:
 	void appendDockAreas(const QList<CDockAreaWidget*> NewDockAreas);
 
 	/**
-	 * Save state of child nodes
+	 * Rebuilds the spatial index of the visible dock areas used by
+	 * dockAreaAt(). The index is a coarse grid over the container and each
+	 * grid cell stores the dock areas that overlap it. The dock area
+	 * geometries are stored in container coordinates, so moving the
+	 * container window does not invalidate the index
+	 */
+	void updateDockAreaIndex();
+
+	/**
+	 * Returns the indexed dock area at the given position in container
+	 * coordinates
+	 */
+	CDockAreaWidget* indexedDockAreaAt(const QPoint& Pos) const;
+
+	/**
+	 * Save state of child nodes into the pre-order node list
 	 */
-	void saveChildNodesState(QXmlStreamWriter& Stream, QWidget* Widget);
+	void saveChildNodesState(QVector<DockLayoutNode>& Nodes, QWidget* Widget);
 
 	/**
 	 * Save state of auto hide widgets
 	 */
-    void saveAutoHideWidgetsState(QXmlStreamWriter& Stream);
+    void saveAutoHideWidgetsState(QVector<AutoHideSideBarState>& SideBars);
 
-    /**
-	 * Restore state of child nodes.
-	 * \param[in] Stream The data stream that contains the serialized state
-	 * \param[out] CreatedWidget The widget created from parsed data or 0 if
-	 * the parsed widget was an empty splitter
-	 * \param[in] Testing If Testing is true, only the stream data is
-	 * parsed without modifying anything.
+	/**
+	 * Restore the splitter tree and the auto hide side bars from the given
+	 * container state.
+	 * Returns the created root widget or 0 if the root splitter is empty
 	 */
-	bool restoreChildNodes(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreChildNodes(const DockContainerState& State);
+
+	/**
+	 * Restores the layout node with the given index and all its child nodes.
+	 * On return, Index points to the node after the restored sub tree.
+	 * Returns the created widget or 0 if the node was an empty splitter
+	 */
+	QWidget* restoreNode(const QVector<DockLayoutNode>& Nodes, int& Index);
 
 	/**
 	 * Restores a splitter.
-	 * \see restoreChildNodes() for details
+	 * \see restoreNode() for details
 	 */
-	bool restoreSplitter(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreSplitter(const QVector<DockLayoutNode>& Nodes, int& Index);
 
 	/**
 	 * Restores a dock area.
-	 * \see restoreChildNodes() for details
 	 */
-	bool restoreDockArea(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreDockArea(const DockAreaState& State);
 
-    /**
-     * Restores a auto hide side bar
-     */
-    bool restoreSideBar(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-        bool Testing);
+	/**
+	 * Restores a auto hide side bar
+	 */
+	void restoreSideBar(const AutoHideSideBarState& State);
+
+	/**
+	 * Adds the given splitter and all splitters in its sub tree to Splitters
+	 */
+	void collectSplitters(CDockSplitter* Splitter, QSet<CDockSplitter*>& Splitters);
+
+	/**
+	 * Updates the layout node with the given index and all its child nodes
+	 * in place. On return, Index points to the node after the updated sub
+	 * tree. Returns the reused or created widget or 0 if the node contains
+	 * no existing dock widgets
+	 */
+	QWidget* updateNode(const QVector<DockLayoutNode>& Nodes, int& Index,
+		LayoutUpdate& Update);
+
+	/**
+	 * Returns the splitter for the given child widgets. The old parent
+	 * splitter of the children is reused, if it has the given orientation
+	 * and if it is not used by another node. Otherwise a new splitter
+	 * is created. The children are moved to the first positions of the
+	 * splitter in the given order
+	 */
+	CDockSplitter* updateSplitter(const QList<QWidget*>& Children,
+		Qt::Orientation Orientation, LayoutUpdate& Update);
+
+	/**
+	 * Updates the dock area that prepareStateUpdate() assigned to the node
+	 * with the given index or creates a new one. Only dock widgets at the
+	 * wrong position are moved
+	 */
+	CDockAreaWidget* updateDockArea(int NodeIndex, const DockAreaState& State,
+		LayoutUpdate& Update);
+
+	/**
+	 * Restores the given side bar and flags the auto hide widgets, that have
+	 * already been in this side bar, as unchanged
+	 */
+	void updateSideBar(const AutoHideSideBarState& State);
+
+	/**
+	 * Removes the given splitter or dock area, that is not part of the
+	 * updated layout anymore, and hands it over to the widget pool or
+	 * deletes it
+	 */
+	void discardWidget(QWidget* Widget);
 
 	/**
 	 * Helper function for recursive dumping of layout
@@ -327,13 +391,19 @@ public:
 	void emitDockAreasRemoved()
 	{
 		onVisibleDockAreaCountChanged();
-		Q_EMIT _this->dockAreasRemoved();
+		if (!DockManager || !DockManager->deferDockAreasChanged(_this, false))
+		{
+			Q_EMIT _this->dockAreasRemoved();
+		}
 	}
 
 	void emitDockAreasAdded()
 	{
 		onVisibleDockAreaCountChanged();
-		Q_EMIT _this->dockAreasAdded();
+		if (!DockManager || !DockManager->deferDockAreasChanged(_this, true))
+		{
+			Q_EMIT _this->dockAreasAdded();
+		}
 	}
 
 	/**
@@ -341,12 +411,49 @@ public:
 	 */
 	CDockSplitter* newSplitter(Qt::Orientation orientation, QWidget* parent = nullptr)
 	{
-		CDockSplitter* s = new CDockSplitter(orientation, parent);
+		CDockSplitter* s = DockManager ? DockManager->takePooledSplitter(parent) : nullptr;
+		if (s)
+		{
+			s->setOrientation(orientation);
+		}
+		else
+		{
+			s = new CDockSplitter(orientation, parent);
+		}
 		s->setOpaqueResize(CDockManager::testConfigFlag(CDockManager::OpaqueSplitterResize));
 		s->setChildrenCollapsible(false);
 		return s;
 	}
 
+	/**
+	 * Hands the empty dock areas and splitters of the given splitter tree
+	 * over to the dock manager for reuse. All widgets that are not recycled
+	 * remain in the tree and are deleted together with it.
+	 */
+	void recycleSplitterTree(CDockSplitter* Splitter)
+	{
+		for (int i = Splitter->count() - 1; i >= 0; --i)
+		{
+			QWidget* Widget = Splitter->widget(i);
+			auto ChildSplitter = qobject_cast<CDockSplitter*>(Widget);
+			if (ChildSplitter)
+			{
+				recycleSplitterTree(ChildSplitter);
+				if (!ChildSplitter->count())
+				{
+					DockManager->recycleSplitter(ChildSplitter);
+				}
+				continue;
+			}
+
+			auto DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+			if (DockArea && !DockArea->dockWidgetsCount())
+			{
+				DockManager->recycleDockArea(DockArea);
+			}
+		}
+	}
+
 	/**
 	 * Ensures equal distribution of the sizes of a splitter if an dock widget
 	 * is inserted from code
@@ -382,7 +489,6 @@ public:
 	void onDockAreaViewToggled(bool Visible)
 	{
 		CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(_this->sender());
-		VisibleDockAreaCount += Visible ? 1 : -1;
 		onVisibleDockAreaCountChanged();
 		Q_EMIT _this->dockAreaViewToggled(DockArea, Visible);
 	}
@@ -696,7 +802,10 @@ void DockContainerWidgetPrivate::moveIntoCenterOfSection(QWidget* Widget, CDockA
 		}
 		TargetArea->setCurrentIndex(TabIndex + NewCurrentIndex);
 		DroppedArea->dockContainer()->removeDockArea(DroppedArea);
-		DroppedArea->deleteLater();
+		if (!DockManager->recycleDockArea(DroppedArea))
+		{
+			DroppedArea->deleteLater();
+		}
 	}
 
 	TargetArea->updateTitleBarVisibility();
@@ -722,7 +831,7 @@ void DockContainerWidgetPrivate::moveToNewSection(QWidget* Widget, CDockAreaWidg
 	CDockAreaWidget* NewDockArea;
 	if (DroppedDockWidget)
 	{
-		NewDockArea = new CDockAreaWidget(DockManager, _this);
+		NewDockArea = DockManager->createDockArea(_this);
 		CDockAreaWidget* OldDockArea = DroppedDockWidget->dockAreaWidget();
 		if (OldDockArea)
 		{
@@ -858,7 +967,7 @@ void DockContainerWidgetPrivate::moveToContainer(QWidget* Widget, DockWidgetArea
 
 	if (DroppedDockWidget)
 	{
-		NewDockArea = new CDockAreaWidget(DockManager, _this);
+		NewDockArea = DockManager->createDockArea(_this);
 		CDockAreaWidget* OldDockArea = DroppedDockWidget->dockAreaWidget();
 		if (OldDockArea)
 		{
@@ -932,6 +1041,7 @@ void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*> N
 	{
 		DockAreas.append(newDockArea);
 	}
+	VisibleDockAreaCount = -1;
 	for (auto DockArea : NewDockAreas)
 	{
 		QObject::connect(DockArea,
@@ -943,42 +1053,103 @@ void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*> N
 
 
 //============================================================================
-void DockContainerWidgetPrivate::saveChildNodesState(QXmlStreamWriter& s, QWidget* Widget)
+void DockContainerWidgetPrivate::saveChildNodesState(QVector<DockLayoutNode>& Nodes,
+	QWidget* Widget)
 {
 	QSplitter* Splitter = qobject_cast<QSplitter*>(Widget);
 	if (Splitter)
 	{
-		s.writeStartElement("Splitter");
-		s.writeAttribute("Orientation", (Splitter->orientation() == Qt::Horizontal) ? "|" : "-");
-		s.writeAttribute("Count", QString::number(Splitter->count()));
         ADS_PRINT("NodeSplitter orient: " << Splitter->orientation()
             << " WidgetCont: " << Splitter->count());
-			for (int i = 0; i < Splitter->count(); ++i)
-			{
-				saveChildNodesState(s, Splitter->widget(i));
-			}
-
-			s.writeStartElement("Sizes");
-			for (auto Size : Splitter->sizes())
+		int SplitterIndex = Nodes.count();
+		DockLayoutNode Node;
+		Node.Type = DockLayoutNode::SplitterNode;
+		Node.Orientation = Splitter->orientation();
+		Node.Sizes = Splitter->sizes();
+		Nodes.append(Node);
+		for (int i = 0; i < Splitter->count(); ++i)
+		{
+			int Count = Nodes.count();
+			saveChildNodesState(Nodes, Splitter->widget(i));
+			if (Nodes.count() > Count)
 			{
-				s.writeCharacters(QString::number(Size) + " ");
+				Nodes[SplitterIndex].ChildCount++;
 			}
-			s.writeEndElement();
-		s.writeEndElement();
+		}
 	}
 	else
 	{
 		CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(Widget);
 		if (DockArea)
 		{
-			DockArea->saveState(s);
+			DockLayoutNode Node;
+			Node.Type = DockLayoutNode::AreaNode;
+			DockArea->saveState(Node.Area);
+			Nodes.append(Node);
+		}
+	}
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::updateDockAreaIndex()
+{
+	IndexedDockAreas.clear();
+	DockAreaGrid.fill(QVector<int>(), DockAreaGridSize * DockAreaGridSize);
+	DockAreaIndexValid = true;
+	DockAreaGridCellSize = QSize(
+		qMax(1, (_this->width() + DockAreaGridSize - 1) / DockAreaGridSize),
+		qMax(1, (_this->height() + DockAreaGridSize - 1) / DockAreaGridSize));
+	for (const auto& DockArea : DockAreas)
+	{
+		if (!DockArea || !DockArea->isVisibleTo(_this))
+		{
+			continue;
+		}
+
+		QRect Rect(DockArea->mapTo(_this, QPoint(0, 0)), DockArea->size());
+		int Index = IndexedDockAreas.count();
+		IndexedDockAreas.append(qMakePair(Rect, DockArea));
+		int Left = qBound(0, Rect.left() / DockAreaGridCellSize.width(), DockAreaGridSize - 1);
+		int Right = qBound(0, Rect.right() / DockAreaGridCellSize.width(), DockAreaGridSize - 1);
+		int Top = qBound(0, Rect.top() / DockAreaGridCellSize.height(), DockAreaGridSize - 1);
+		int Bottom = qBound(0, Rect.bottom() / DockAreaGridCellSize.height(), DockAreaGridSize - 1);
+		for (int Row = Top; Row <= Bottom; ++Row)
+		{
+			for (int Column = Left; Column <= Right; ++Column)
+			{
+				DockAreaGrid[Row * DockAreaGridSize + Column].append(Index);
+			}
 		}
 	}
 }
 
 
 //============================================================================
-void DockContainerWidgetPrivate::saveAutoHideWidgetsState(QXmlStreamWriter& s)
+CDockAreaWidget* DockContainerWidgetPrivate::indexedDockAreaAt(const QPoint& Pos) const
+{
+	if (!_this->rect().contains(Pos))
+	{
+		return nullptr;
+	}
+
+	int Column = qMin(Pos.x() / DockAreaGridCellSize.width(), DockAreaGridSize - 1);
+	int Row = qMin(Pos.y() / DockAreaGridCellSize.height(), DockAreaGridSize - 1);
+	for (int Index : DockAreaGrid[Row * DockAreaGridSize + Column])
+	{
+		const auto& Entry = IndexedDockAreas[Index];
+		if (Entry.first.contains(Pos))
+		{
+			return Entry.second;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::saveAutoHideWidgetsState(QVector<AutoHideSideBarState>& SideBars)
 {
 	for (const auto sideTabBar : SideTabBarWidgets.values())
     {
@@ -987,247 +1158,360 @@ void DockContainerWidgetPrivate::saveAutoHideWidgetsState(QXmlStreamWriter& s)
 			continue;
 		}
 
-		sideTabBar->saveState(s);
+		AutoHideSideBarState SideBar;
+		sideTabBar->saveState(SideBar);
+		SideBars.append(SideBar);
     }
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreSplitter(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::restoreSplitter(const QVector<DockLayoutNode>& Nodes,
+	int& Index)
 {
-	bool Ok;
-	QString OrientationStr = s.attributes().value("Orientation").toString();
+	const auto& Node = Nodes[Index++];
+    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Node.Orientation <<
+            " WidgetCount: " << Node.Sizes.count());
+	CDockSplitter* Splitter = newSplitter(Node.Orientation);
+	bool Visible = false;
+	for (int i = 0; i < Node.ChildCount; ++i)
+	{
+		QWidget* ChildNode = restoreNode(Nodes, Index);
+		if (!ChildNode)
+		{
+			continue;
+		}
+
+        ADS_PRINT("ChildNode isVisible " << ChildNode->isVisible()
+            << " isVisibleTo " << ChildNode->isVisibleTo(Splitter));
+		Splitter->addWidget(ChildNode);
+		Visible |= ChildNode->isVisibleTo(Splitter);
+	}
+	updateSplitterHandles(Splitter);
 
-	// Check if the orientation string is right
-	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
+	if (!Splitter->count())
 	{
-		return false;
+		if (!DockManager->recycleSplitter(Splitter))
+		{
+			delete Splitter;
+		}
+		return nullptr;
 	}
 
-	// The "|" shall indicate a vertical splitter handle which in turn means
-	// a Horizontal orientation of the splitter layout.
-	bool HorizontalSplitter = OrientationStr.startsWith("|");
-	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
-	// but this is wrong, because only the splitter handle is vertical, the
-	// layout of the splitter is a horizontal layout. We fix this here
-	if (s.fileVersion() == 0)
+	Splitter->setSizes(Node.Sizes);
+	Splitter->setVisible(Visible);
+	return Splitter;
+}
+
+
+//============================================================================
+QWidget* DockContainerWidgetPrivate::restoreDockArea(const DockAreaState& State)
+{
+	CDockAreaWidget* DockArea = CDockAreaWidget::restoreState(State, _this);
+	if (DockArea)
 	{
-		HorizontalSplitter = !HorizontalSplitter;
+		appendDockAreas({DockArea});
 	}
+	return DockArea;
+}
+
 
-	int Orientation = HorizontalSplitter ? Qt::Horizontal : Qt::Vertical;
-	int WidgetCount = s.attributes().value("Count").toInt(&Ok);
-	if (!Ok)
+//============================================================================
+QWidget* DockContainerWidgetPrivate::restoreNode(const QVector<DockLayoutNode>& Nodes,
+	int& Index)
+{
+	if (Nodes[Index].Type == DockLayoutNode::SplitterNode)
 	{
-		return false;
+		ADS_PRINT("Splitter");
+		return restoreSplitter(Nodes, Index);
 	}
-    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Orientation <<
-            " WidgetCount: " << WidgetCount);
-	QSplitter* Splitter = nullptr;
-	if (!Testing)
+	else
 	{
-		Splitter = newSplitter(static_cast<Qt::Orientation>(Orientation));
+		ADS_PRINT("DockAreaWidget");
+		return restoreDockArea(Nodes[Index++].Area);
 	}
-	bool Visible = false;
-	QList<int> Sizes;
-	while (s.readNextStartElement())
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::restoreSideBar(const AutoHideSideBarState& State)
+{
+	// Simply ignore side bar auto hide widgets from saved state if
+	// auto hide support is disabled
+	if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
 	{
-		QWidget* ChildNode = nullptr;
-		bool Result = true;
-        if (s.name() == QLatin1String("Splitter"))
-		{
-			Result = restoreSplitter(s, ChildNode, Testing);
-		}
-        else if (s.name() == QLatin1String("Area"))
+		return;
+	}
+
+	for (const auto& WidgetState : State.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Name);
+		if (!DockWidget)
 		{
-			Result = restoreDockArea(s, ChildNode, Testing);
+			continue;
 		}
-        else if (s.name() == QLatin1String("Sizes"))
+
+		auto SideBar = _this->autoHideSideBar(State.Location);
+		CAutoHideDockContainer* AutoHideContainer;
+		if (DockWidget->isAutoHide())
 		{
-			QString sSizes = s.readElementText().trimmed();
-            ADS_PRINT("Sizes: " << sSizes);
-			QTextStream TextStream(&sSizes);
-			while (!TextStream.atEnd())
+			AutoHideContainer = DockWidget->autoHideDockContainer();
+			if (AutoHideContainer->autoHideSideBar() != SideBar)
 			{
-				int value;
-				TextStream >> value;
-				Sizes.append(value);
+				SideBar->addAutoHideWidget(AutoHideContainer);
 			}
 		}
 		else
 		{
-			s.skipCurrentElement();
-		}
-
-		if (!Result)
-		{
-			return false;
+			AutoHideContainer = SideBar->insertDockWidget(-1, DockWidget);
 		}
+		AutoHideContainer->setSize(WidgetState.Size);
+        DockWidget->setProperty(internal::ClosedProperty, WidgetState.Closed);
+		DockWidget->setProperty(internal::DirtyProperty, false);
+	}
+}
 
-		if (Testing || !ChildNode)
-		{
-			continue;
-		}
 
-        ADS_PRINT("ChildNode isVisible " << ChildNode->isVisible()
-            << " isVisibleTo " << ChildNode->isVisibleTo(Splitter));
-		Splitter->addWidget(ChildNode);
-		Visible |= ChildNode->isVisibleTo(Splitter);
+//============================================================================
+QWidget* DockContainerWidgetPrivate::restoreChildNodes(const DockContainerState& State)
+{
+	QWidget* CreatedWidget = nullptr;
+	if (!State.Nodes.isEmpty())
+	{
+		int Index = 0;
+		CreatedWidget = restoreNode(State.Nodes, Index);
 	}
-    if(!Testing)
-    {
-       updateSplitterHandles(Splitter);
-    }
 
-	if (Sizes.count() != WidgetCount)
+	for (const auto& SideBar : State.SideBars)
 	{
-		return false;
+		ADS_PRINT("SideBar");
+		restoreSideBar(SideBar);
 	}
 
-	if (!Testing)
+	return CreatedWidget;
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::collectSplitters(CDockSplitter* Splitter,
+	QSet<CDockSplitter*>& Splitters)
+{
+	if (!Splitter)
 	{
-		if (!Splitter->count())
-		{
-			delete Splitter;
-			Splitter = nullptr;
-		}
-		else
-		{
-			Splitter->setSizes(Sizes);
-			Splitter->setVisible(Visible);
-		}
-		CreatedWidget = Splitter;
+		return;
 	}
-	else
+
+	Splitters.insert(Splitter);
+	for (int i = 0; i < Splitter->count(); ++i)
 	{
-		CreatedWidget = nullptr;
+		collectSplitters(qobject_cast<CDockSplitter*>(Splitter->widget(i)), Splitters);
 	}
-
-	return true;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreDockArea(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::updateNode(const QVector<DockLayoutNode>& Nodes,
+	int& Index, LayoutUpdate& Update)
 {
-	CDockAreaWidget* DockArea = nullptr;
-	auto Result = CDockAreaWidget::restoreState(s, DockArea, Testing, _this);
-	if (Result && DockArea)
+	int NodeIndex = Index++;
+	const auto& Node = Nodes[NodeIndex];
+	if (Node.Type == DockLayoutNode::AreaNode)
 	{
-		appendDockAreas({DockArea});
+		return updateDockArea(NodeIndex, Node.Area, Update);
 	}
-	CreatedWidget = DockArea;
-	return Result;
+
+	QList<QWidget*> Children;
+	for (int i = 0; i < Node.ChildCount; ++i)
+	{
+		QWidget* Child = updateNode(Nodes, Index, Update);
+		if (Child)
+		{
+			Children.append(Child);
+		}
+	}
+
+	if (Children.isEmpty())
+	{
+		return nullptr;
+	}
+
+	SplitterUpdate Entry;
+	Entry.Splitter = updateSplitter(Children, Node.Orientation, Update);
+	Entry.ChildCount = Children.count();
+	Entry.Node = &Node;
+	Update.Splitters.append(Entry);
+	return Entry.Splitter;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreSideBar(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+CDockSplitter* DockContainerWidgetPrivate::updateSplitter(const QList<QWidget*>& Children,
+	Qt::Orientation Orientation, LayoutUpdate& Update)
 {
-	Q_UNUSED(CreatedWidget)
-	// Simply ignore side bar auto hide widgets from saved state if
-	// auto hide support is disabled
-	if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
+	CDockSplitter* Splitter = nullptr;
+	for (auto Child : Children)
 	{
-		return true;
+		auto Parent = qobject_cast<CDockSplitter*>(Child->parentWidget());
+		if (Parent && Parent->orientation() == Orientation
+		 && Update.OldSplitters.remove(Parent))
+		{
+			Splitter = Parent;
+			break;
+		}
 	}
 
-	bool Ok;
-	auto Area = (ads::SideBarLocation)s.attributes().value("Area").toInt(&Ok);
-	if (!Ok)
+	if (!Splitter)
 	{
-		return false;
+		Splitter = newSplitter(Orientation);
 	}
 
-	while (s.readNextStartElement())
+	// Children that are already at the right position are not touched.
+	// Remaining old children are removed, when the complete layout has
+	// been updated, because they may be reused by other nodes
+	for (int i = 0; i < Children.count(); ++i)
 	{
-		if (s.name() != QLatin1String("Widget"))
+		if (Splitter->widget(i) != Children[i])
 		{
-			continue;
+			Splitter->insertWidget(i, Children[i]);
 		}
+	}
+
+	return Splitter;
+}
 
-		auto Name = s.attributes().value("Name");
-		if (Name.isEmpty())
-		{
-			return false;
-		}
 
-		bool Ok;
-		bool Closed = s.attributes().value("Closed").toInt(&Ok);
-		if (!Ok)
+//============================================================================
+CDockAreaWidget* DockContainerWidgetPrivate::updateDockArea(int NodeIndex,
+	const DockAreaState& State, LayoutUpdate& Update)
+{
+	CDockAreaWidget* DockArea = UpdatedDockAreas.value(NodeIndex);
+	bool Changed = !DockArea || ChangedDockAreas.contains(DockArea);
+	if (!DockArea)
+	{
+		DockArea = DockManager->createDockArea(_this);
+		Update.CreatedDockAreas.insert(DockArea);
+	}
+	DockArea->setAllowedAreas((DockWidgetArea)State.AllowedAreas);
+	DockArea->setDockAreaFlags((CDockAreaWidget::DockAreaFlags)State.Flags);
+
+	QList<CDockWidget*> DockWidgets;
+	for (const auto& WidgetState : State.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Name);
+		if (!DockWidget)
 		{
-			return false;
+			continue;
 		}
 
-		int Size = s.attributes().value("Size").toInt(&Ok);
-		if (!Ok)
+		int Index = DockWidgets.count();
+		if (DockArea->dockWidget(Index) != DockWidget)
 		{
-			return false;
+			Changed = true;
+			if (DockWidget->autoHideDockContainer())
+			{
+				DockWidget->autoHideDockContainer()->cleanupAndDelete();
+			}
+			else if (DockWidget->dockAreaWidget())
+			{
+				DockWidget->dockAreaWidget()->releaseDockWidget(DockWidget);
+			}
+			DockArea->insertDockWidget(Index, DockWidget, false);
 		}
+		DockWidgets.append(DockWidget);
+		DockWidget->setProperty(internal::ClosedProperty, WidgetState.Closed);
+		DockWidget->setProperty(internal::DirtyProperty, false);
+	}
 
-		s.skipCurrentElement();
-		CDockWidget* DockWidget = DockManager->findDockWidget(Name.toString());
-		if (!DockWidget || Testing)
+	if (DockWidgets.isEmpty())
+	{
+		// An assigned dock area that is not part of the layout anymore is
+		// removed together with the other remaining widgets of the old layout
+		if (Update.CreatedDockAreas.remove(DockArea)
+		 && !DockManager->recycleDockArea(DockArea))
 		{
-			continue;
+			delete DockArea;
 		}
+		return nullptr;
+	}
 
-		auto SideBar = _this->autoHideSideBar(Area);
-		CAutoHideDockContainer* AutoHideContainer;
-		if (DockWidget->isAutoHide())
+	if (Changed)
+	{
+		// Like a restored dock area, a changed dock area is hidden until
+		// the dock manager opens its dock widgets again
+		DockArea->hide();
+		for (auto DockWidget : DockWidgets)
 		{
-			AutoHideContainer = DockWidget->autoHideDockContainer();
-			if (AutoHideContainer->autoHideSideBar() != SideBar)
-			{
-				SideBar->addAutoHideWidget(AutoHideContainer);
-			}
+			bool Closed = DockWidget->property(internal::ClosedProperty).toBool();
+			DockWidget->setToggleViewActionChecked(!Closed);
+			DockWidget->setClosedState(Closed);
 		}
-		else
+	}
+	else
+	{
+		for (auto DockWidget : DockWidgets)
 		{
-			AutoHideContainer = SideBar->insertDockWidget(-1, DockWidget);
+			DockWidget->setProperty(internal::UnchangedProperty, true);
 		}
-		AutoHideContainer->setSize(Size);
-        DockWidget->setProperty(internal::ClosedProperty, Closed);
-		DockWidget->setProperty(internal::DirtyProperty, false);
 	}
 
-	return true;
+	DockArea->setProperty("currentDockWidget", State.CurrentDockWidget);
+	Update.DockAreas.append(DockArea);
+	return DockArea;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreChildNodes(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+void DockContainerWidgetPrivate::updateSideBar(const AutoHideSideBarState& State)
 {
-	bool Result = true;
-	while (s.readNextStartElement())
+	if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
 	{
-        if (s.name() == QLatin1String("Splitter"))
+		return;
+	}
+
+	auto SideBar = _this->autoHideSideBar(State.Location);
+	QList<CDockWidget*> UnchangedDockWidgets;
+	for (const auto& WidgetState : State.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Name);
+		if (DockWidget && DockWidget->isAutoHide()
+		 && DockWidget->autoHideDockContainer()->autoHideSideBar() == SideBar)
 		{
-			Result = restoreSplitter(s, CreatedWidget, Testing);
-            ADS_PRINT("Splitter");
+			UnchangedDockWidgets.append(DockWidget);
 		}
-        else if (s.name() == QLatin1String("Area"))
+	}
+
+	restoreSideBar(State);
+	for (auto DockWidget : UnchangedDockWidgets)
+	{
+		DockWidget->setProperty(internal::UnchangedProperty, true);
+	}
+}
+
+
+//============================================================================
+void DockContainerWidgetPrivate::discardWidget(QWidget* Widget)
+{
+	auto Splitter = qobject_cast<CDockSplitter*>(Widget);
+	if (Splitter)
+	{
+		recycleSplitterTree(Splitter);
+		if (DockManager->recycleSplitter(Splitter))
 		{
-			Result = restoreDockArea(s, CreatedWidget, Testing);
-            ADS_PRINT("DockAreaWidget");
+			return;
 		}
-        else if (s.name() == QLatin1String("SideBar"))
-        {
-        	Result = restoreSideBar(s, CreatedWidget, Testing);
-        	ADS_PRINT("SideBar");
-        }
-		else
+	}
+	else
+	{
+		auto DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+		if (DockArea && DockManager->recycleDockArea(DockArea))
 		{
-			s.skipCurrentElement();
-            ADS_PRINT("Unknown element");
+			return;
 		}
 	}
 
-	return Result;
+	Widget->hide();
+	Widget->setParent(nullptr);
+	Widget->deleteLater();
 }
 
 
@@ -1235,7 +1519,7 @@ bool DockContainerWidgetPrivate::restoreChildNodes(CDockingStateReader& s,
 CDockAreaWidget* DockContainerWidgetPrivate::addDockWidgetToContainer(DockWidgetArea area,
 	CDockWidget* Dockwidget)
 {
-	CDockAreaWidget* NewDockArea = new CDockAreaWidget(DockManager, _this);
+	CDockAreaWidget* NewDockArea = DockManager->createDockArea(_this);
 	NewDockArea->addDockWidget(Dockwidget);
 	addDockArea(NewDockArea, area);
 	NewDockArea->updateTitleBarVisibility();
@@ -1358,7 +1642,7 @@ CDockAreaWidget* DockContainerWidgetPrivate::addDockWidgetToDockArea(DockWidgetA
 		return TargetDockArea;
 	}
 
-	CDockAreaWidget* NewDockArea = new CDockAreaWidget(DockManager, _this);
+	CDockAreaWidget* NewDockArea = DockManager->createDockArea(_this);
 	NewDockArea->addDockWidget(Dockwidget);
 	auto InsertParam = internal::dockAreaInsertParameters(area);
 
@@ -1405,6 +1689,7 @@ CDockContainerWidget::CDockContainerWidget(CDockManager* DockManager, QWidget *p
 {
 	d->DockManager = DockManager;
 	d->isFloating = floatingWidget() != nullptr;
+	d->LayoutGeneration = nextLayoutGeneration();
 
 	d->Layout = new QGridLayout();
 	d->Layout->setContentsMargins(0, 0, 0, 0);
@@ -1531,6 +1816,10 @@ bool CDockContainerWidget::event(QEvent *e)
 	{
 		d->zOrderIndex = ++zOrderCounter;
 	}
+	else if (e->type() == QEvent::Resize)
+	{
+		d->DockAreaIndexValid = false;
+	}
 
 	return Result;
 }
@@ -1570,6 +1859,7 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
 
 	area->disconnect(this);
 	d->DockAreas.removeAll(area);
+	d->VisibleDockAreaCount = -1;
 	auto Splitter = area->parentSplitter();
 
 	// Remove are from parent splitter and recursively hide tree of parent
@@ -1628,7 +1918,10 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
 		ParentSplitter->setSizes(Sizes);
 	}
 
-	delete Splitter;
+	if (!d->DockManager->recycleSplitter(Splitter))
+	{
+		delete Splitter;
+	}
     Splitter = nullptr;
 
 emitAndExit:
@@ -1648,6 +1941,7 @@ QList<QPointer<CDockAreaWidget>> CDockContainerWidget::removeAllDockAreas()
 {
 	auto Result = d->DockAreas;
 	d->DockAreas.clear();
+	d->VisibleDockAreaCount = -1;
 	return Result;
 }
 
@@ -1655,15 +1949,20 @@ QList<QPointer<CDockAreaWidget>> CDockContainerWidget::removeAllDockAreas()
 //============================================================================
 CDockAreaWidget* CDockContainerWidget::dockAreaAt(const QPoint& GlobalPos) const
 {
-	for (const auto& DockArea : d->DockAreas)
+	if (!isVisible())
 	{
-		if (DockArea && DockArea->isVisible() && DockArea->rect().contains(DockArea->mapFromGlobal(GlobalPos)))
-		{
-			return DockArea;
-		}
+		return nullptr;
 	}
 
-	return nullptr;
+	// The index is invalidated by all layout changes, by resizing this
+	// container and by geometry and visibility changes of the dock areas.
+	// So a valid index is always up to date and a miss is final.
+	if (!d->DockAreaIndexValid)
+	{
+		d->updateDockAreaIndex();
+	}
+
+	return d->indexedDockAreaAt(mapFromGlobal(GlobalPos));
 }
 
 
@@ -1691,17 +1990,10 @@ int CDockContainerWidget::dockAreaCount() const
 //============================================================================
 int CDockContainerWidget::visibleDockAreaCount() const
 {
-	int Result = 0;
-	for (auto DockArea : d->DockAreas)
-	{
-		Result += (!DockArea || DockArea->isHidden()) ? 0 : 1;
-	}
-
-	return Result;
-
-	// TODO Cache or precalculate this to speed it up because it is used during
-	// movement of floating widget
-	//return d->visibleDockAreaCount();
+	// The count is cached because it is used during movement of floating
+	// widgets. It is invalidated if dock areas are added, removed, shown
+	// or hidden
+	return d->visibleDockAreaCount();
 }
 
 
@@ -1865,87 +2157,271 @@ void CDockContainerWidget::saveState(QXmlStreamWriter& s) const
     ADS_PRINT("CDockContainerWidget::saveState isFloating "
         << isFloating());
 
-	s.writeStartElement("Container");
-	s.writeAttribute("Floating", QString::number(isFloating() ? 1 : 0));
-	if (isFloating())
+	DockContainerState State;
+	saveState(State);
+	State.writeXml(s);
+}
+
+
+//============================================================================
+void CDockContainerWidget::saveState(DockContainerState& State) const
+{
+	State.Floating = isFloating();
+	if (State.Floating)
 	{
+		State.Geometry = floatingWidget()->saveGeometry();
+	}
+	d->saveChildNodesState(State.Nodes, d->RootSplitter);
+	d->saveAutoHideWidgetsState(State.SideBars);
+}
+
+
+//============================================================================
+void CDockContainerWidget::restoreState(const DockContainerState& State)
+{
+    ADS_PRINT("Restore CDockContainerWidget Floating" << State.Floating);
+	d->VisibleDockAreaCount = -1;// invalidate the dock area count
+	d->DockAreas.clear();
+	std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
+
+	if (State.Floating)
+	{
+        ADS_PRINT("Restore floating widget");
 		CFloatingDockContainer* FloatingWidget = floatingWidget();
-		QByteArray Geometry = FloatingWidget->saveGeometry();
-#if QT_VERSION < 0x050900
-        s.writeTextElement("Geometry", qByteArrayToHex(Geometry, ' '));
-#else
-		s.writeTextElement("Geometry", Geometry.toHex(' '));
-#endif
+		if (FloatingWidget)
+		{
+			FloatingWidget->restoreGeometry(State.Geometry);
+		}
 	}
-	d->saveChildNodesState(s, d->RootSplitter);
-	d->saveAutoHideWidgetsState(s);
-	s.writeEndElement();
+
+	QWidget* NewRootSplitter = d->restoreChildNodes(State);
+
+	// If the root splitter is empty, restoreChildNodes returns a 0 pointer
+	// and we need to create a new empty root splitter. If the root node is
+	// a single dock area, we need to wrap it into a splitter
+	if (!NewRootSplitter)
+	{
+		NewRootSplitter = d->newSplitter(Qt::Horizontal);
+	}
+	else if (!qobject_cast<CDockSplitter*>(NewRootSplitter))
+	{
+		auto Splitter = d->newSplitter(Qt::Horizontal);
+		Splitter->addWidget(NewRootSplitter);
+		NewRootSplitter = Splitter;
+	}
+
+	QLayoutItem* li = d->Layout->replaceWidget(d->RootSplitter, NewRootSplitter);
+	auto OldRoot = d->RootSplitter;
+	d->RootSplitter = qobject_cast<CDockSplitter*>(NewRootSplitter);
+	delete li;
+	d->recycleSplitterTree(OldRoot);
+	if (!d->DockManager->recycleSplitter(OldRoot))
+	{
+		OldRoot->deleteLater();
+	}
+	markLayoutChanged();
 }
 
 
 //============================================================================
-bool CDockContainerWidget::restoreState(CDockingStateReader& s, bool Testing)
+void CDockContainerWidget::prepareStateUpdate(const DockContainerState& State)
 {
-	bool IsFloating = s.attributes().value("Floating").toInt();
-    ADS_PRINT("Restore CDockContainerWidget Floating" << IsFloating);
+	d->UpdatedDockAreas.clear();
+	d->ChangedDockAreas.clear();
 
-	QWidget* NewRootSplitter {};
-	if (!Testing)
+	// The node of the dock area, that each dock widget will be placed in
+	QHash<CDockWidget*, int> TargetNodes;
+	for (int i = 0; i < State.Nodes.count(); ++i)
 	{
-		d->VisibleDockAreaCount = -1;// invalidate the dock area count
-		d->DockAreas.clear();
-		std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
+		for (const auto& WidgetState : State.Nodes[i].Area.DockWidgets)
+		{
+			CDockWidget* DockWidget = d->DockManager->findDockWidget(WidgetState.Name);
+			if (DockWidget)
+			{
+				TargetNodes.insert(DockWidget, i);
+			}
+		}
 	}
 
-	if (IsFloating)
+	// Each node reuses the existing dock area of its first dock widget,
+	// that is in a dock area of this container, which has not been
+	// assigned to a previous node
+	QHash<CDockAreaWidget*, int> AssignedNodes;
+	for (int i = 0; i < State.Nodes.count(); ++i)
 	{
-        ADS_PRINT("Restore floating widget");
-        if (!s.readNextStartElement() || s.name() != QLatin1String("Geometry"))
+		for (const auto& WidgetState : State.Nodes[i].Area.DockWidgets)
 		{
-			return false;
+			CDockWidget* DockWidget = d->DockManager->findDockWidget(WidgetState.Name);
+			CDockAreaWidget* DockArea = DockWidget ? DockWidget->dockAreaWidget() : nullptr;
+			if (DockArea && d->DockAreas.contains(DockArea) && !AssignedNodes.contains(DockArea))
+			{
+				AssignedNodes.insert(DockArea, i);
+				d->UpdatedDockAreas.insert(i, DockArea);
+				break;
+			}
 		}
+	}
 
-		QByteArray GeometryString = s.readElementText(CDockingStateReader::ErrorOnUnexpectedElement).toLocal8Bit();
-		QByteArray Geometry = QByteArray::fromHex(GeometryString);
-		if (Geometry.isEmpty())
+	for (auto DockArea : d->DockAreas)
+	{
+		if (!DockArea)
 		{
-			return false;
+			continue;
 		}
 
-		if (!Testing)
+		int Node = AssignedNodes.value(DockArea, -1);
+		for (auto DockWidget : DockArea->dockWidgets())
 		{
-			CFloatingDockContainer* FloatingWidget = floatingWidget();
-			if (FloatingWidget)
+			if (Node < 0 || TargetNodes.value(DockWidget, -1) != Node)
 			{
-				FloatingWidget->restoreGeometry(Geometry);
+				DockArea->releaseDockWidget(DockWidget);
+				d->ChangedDockAreas.insert(DockArea);
 			}
 		}
 	}
+}
+
 
-	if (!d->restoreChildNodes(s, NewRootSplitter, Testing))
+//============================================================================
+void CDockContainerWidget::updateState(const DockContainerState& State)
+{
+    ADS_PRINT("Update CDockContainerWidget Floating" << State.Floating);
+	if (State.Floating)
 	{
-		return false;
+		CFloatingDockContainer* FloatingWidget = floatingWidget();
+		if (FloatingWidget && FloatingWidget->saveGeometry() != State.Geometry)
+		{
+			FloatingWidget->restoreGeometry(State.Geometry);
+		}
 	}
 
-	if (Testing)
+	LayoutUpdate Update;
+	d->collectSplitters(d->RootSplitter, Update.OldSplitters);
+	QWidget* NewRoot = nullptr;
+	if (!State.Nodes.isEmpty())
 	{
-		return true;
+		int Index = 0;
+		NewRoot = d->updateNode(State.Nodes, Index, Update);
 	}
 
-	// If the root splitter is empty, rostoreChildNodes returns a 0 pointer
-	// and we need to create a new empty root splitter
-	if (!NewRootSplitter)
+	// Like restoreState(), we need a splitter as root widget
+	auto NewRootSplitter = qobject_cast<CDockSplitter*>(NewRoot);
+	if (!NewRoot)
 	{
 		NewRootSplitter = d->newSplitter(Qt::Horizontal);
 	}
+	else if (!NewRootSplitter)
+	{
+		SplitterUpdate Entry;
+		Entry.Splitter = d->updateSplitter({NewRoot}, Qt::Horizontal, Update);
+		Entry.ChildCount = 1;
+		Update.Splitters.append(Entry);
+		NewRootSplitter = Entry.Splitter;
+	}
 
-	QLayoutItem* li = d->Layout->replaceWidget(d->RootSplitter, NewRootSplitter);
 	auto OldRoot = d->RootSplitter;
-	d->RootSplitter = qobject_cast<CDockSplitter*>(NewRootSplitter);
-	OldRoot->deleteLater();
-	delete li;
+	if (NewRootSplitter != OldRoot)
+	{
+		// If the old root splitter has been reused for a child node, it is
+		// not in the layout anymore
+		QLayoutItem* li = d->Layout->replaceWidget(OldRoot, NewRootSplitter);
+		if (li)
+		{
+			delete li;
+		}
+		else
+		{
+			d->Layout->addWidget(NewRootSplitter, 1, 1);
+		}
+		d->RootSplitter = NewRootSplitter;
+	}
+
+	// The splitters are ordered children first, so the visibility of the
+	// children is known, when the visibility of a splitter is updated
+	for (const auto& Entry : Update.Splitters)
+	{
+		auto Splitter = Entry.Splitter;
+		while (Splitter->count() > Entry.ChildCount)
+		{
+			d->discardWidget(Splitter->widget(Entry.ChildCount));
+		}
+		d->updateSplitterHandles(Splitter);
+
+		bool Visible = false;
+		for (int i = 0; i < Splitter->count(); ++i)
+		{
+			Visible |= Splitter->widget(i)->isVisibleTo(Splitter);
+		}
+		if (Entry.Node && Splitter->sizes() != Entry.Node->Sizes)
+		{
+			Splitter->setSizes(Entry.Node->Sizes);
+		}
+		Splitter->setVisible(Visible);
+	}
+
+	if (Update.OldSplitters.contains(OldRoot))
+	{
+		d->discardWidget(OldRoot);
+	}
+
+	d->DockAreas.clear();
+	for (auto DockArea : Update.DockAreas)
+	{
+		if (Update.CreatedDockAreas.contains(DockArea))
+		{
+			d->appendDockAreas({DockArea});
+		}
+		else
+		{
+			d->DockAreas.append(DockArea);
+		}
+	}
+	d->VisibleDockAreaCount = -1;
+	std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
+	d->UpdatedDockAreas.clear();
+	d->ChangedDockAreas.clear();
+
+	for (const auto& SideBar : State.SideBars)
+	{
+		d->updateSideBar(SideBar);
+	}
+	markLayoutChanged();
+}
+
+
+//============================================================================
+void CDockContainerWidget::markLayoutChanged()
+{
+	d->LayoutGeneration = nextLayoutGeneration();
+	d->DockAreaIndexValid = false;
+}
+
+
+//============================================================================
+void CDockContainerWidget::invalidateVisibleDockAreaCount()
+{
+	d->VisibleDockAreaCount = -1;
+}
 
-	return true;
+
+//============================================================================
+void CDockContainerWidget::invalidateDockAreaIndex()
+{
+	d->DockAreaIndexValid = false;
+}
+
+
+//============================================================================
+quint64 CDockContainerWidget::nextLayoutGeneration()
+{
+	return ++layoutGenerationCounter;
+}
+
+
+//============================================================================
+quint64 CDockContainerWidget::layoutGeneration() const
+{
+	return d->LayoutGeneration;
 }
 
 
@@ -50,7 +50,7 @@ class CFloatingDockContainer;
 struct FloatingDockContainerPrivate;
 class CFloatingDragPreview;
 struct FloatingDragPreviewPrivate;
-class CDockingStateReader;
+struct DockContainerState;
 class CAutoHideSideBar;
 class CAutoHideTab;
 class CDockSplitter;
@@ -85,6 +85,7 @@ private:
 	friend AutoHideTabPrivate;
 	friend AutoHideDockContainerPrivate;
 	friend CAutoHideSideBar;
+	friend struct DockSplitterPrivate;
 
 protected:
 	/**
@@ -150,12 +151,63 @@ protected:
 	void saveState(QXmlStreamWriter& Stream) const;
 
 	/**
-	 * Restores the state from given stream.
-	 * If Testing is true, the function only parses the data from the given
-	 * stream but does not restore anything. You can use this check for
-	 * faulty files before you start restoring the state
+	 * Saves the state into the given container state
 	 */
-	bool restoreState(CDockingStateReader& Stream, bool Testing);
+	void saveState(DockContainerState& State) const;
+
+	/**
+	 * Restores the state from the given, already validated, container state
+	 */
+	void restoreState(const DockContainerState& State);
+
+	/**
+	 * Prepares the in place update of this container to the given State.
+	 * The dock area nodes of State are matched with the existing dock areas
+	 * via the identity of their dock widgets. Each existing dock area is
+	 * assigned to the first node that contains one of its dock widgets.
+	 * All dock widgets that do not stay in their dock area are released from
+	 * it. The dock manager calls this function for all updated containers
+	 * before it calls updateState(), so that dock widgets that move between
+	 * containers have already left their old dock area.
+	 */
+	void prepareStateUpdate(const DockContainerState& State);
+
+	/**
+	 * Updates the existing layout to the given State, after
+	 * prepareStateUpdate() has been called. The assigned dock areas and all
+	 * splitters that still contain the same children are reused. Only the
+	 * dock widgets, dock areas and splitters that differ from State are
+	 * inserted, moved or removed. Dock areas whose dock widgets did not
+	 * change are not hidden, so their dock widgets are not shown again.
+	 */
+	void updateState(const DockContainerState& State);
+
+	/**
+	 * Marks the layout of this container as changed. This assigns a new
+	 * layoutGeneration() to this container. The function is called for all
+	 * changes that modify the saved state of this container - i.e. moves,
+	 * splits, splitter size changes, opening and closing of dock widgets
+	 * and auto hide changes.
+	 */
+	void markLayoutChanged();
+
+	/**
+	 * Returns a new, unique layout generation. The generations are
+	 * increasing, so a newer change always has a greater generation.
+	 */
+	static quint64 nextLayoutGeneration();
+
+	/**
+	 * Called by the dock areas if their visibility changed. The cached
+	 * visibleDockAreaCount() is calculated again on next access.
+	 */
+	void invalidateVisibleDockAreaCount();
+
+	/**
+	 * Called by the dock areas if their geometry or visibility changed.
+	 * The index used by dockAreaAt() is rebuilt on next access.
+	 */
+	void invalidateDockAreaIndex();
 
 	/**
 	 * This function returns the last added dock area widget for the given
@@ -249,7 +301,10 @@ public:
 
 	/**
 	 * Returns the dock area at the given global position or 0 if there is no
-	 * dock area at this position
+	 * dock area at this position.
+	 * The function uses a spatial index of the dock areas that is rebuilt
+	 * only if the layout of this container changed, so it is cheap enough
+	 * to be called for every mouse move during dragging.
 	 */
 	CDockAreaWidget* dockAreaAt(const QPoint& GlobalPos) const;
 
@@ -355,6 +410,15 @@ public:
 	 */
 	CDockManager* dockManager() const;
 
+	/**
+	 * Returns the generation of the layout of this container.
+	 * The generation changes whenever something changes in this container,
+	 * that is part of the saved state. If the generation is still the same
+	 * like the generation at the last save, then the saved state of this
+	 * container is still valid.
+	 */
+	quint64 layoutGeneration() const;
+
 
 Q_SIGNALS:
 	/**
@@ -0,0 +1,244 @@
+//============================================================================
+/// \file   DockDragSnapshot.cpp
+/// \date   16.10.2026
+/// \brief  Implementation of CDockDragSnapshot
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockDragSnapshot.h"
+
+#include <algorithm>
+
+#include "DockManager.h"
+#include "DockContainerWidget.h"
+#include "DockAreaWidget.h"
+#include "DockAreaTitleBar.h"
+#include "DockAreaTabBar.h"
+#include "DockWidgetTab.h"
+#include "AutoHideSideBar.h"
+#include "AutoHideTab.h"
+
+namespace ads
+{
+/**
+ * Captures the tab geometries of the given tab bar
+ */
+static DockDragTabsTarget captureTabs(CDockAreaTabBar* TabBar)
+{
+	DockDragTabsTarget Tabs;
+	Tabs.Visible = TabBar->isVisible();
+	Tabs.Orientation = Qt::Horizontal;
+	Tabs.Origin = TabBar->mapToGlobal(QPoint(0, 0));
+	Tabs.TabRects.reserve(TabBar->count());
+	Tabs.TabExtents.reset(TabBar->count());
+	for (int i = 0; i < TabBar->count(); ++i)
+	{
+		auto Tab = TabBar->tab(i);
+		const QRect TabRect = Tab->geometry();
+		Tabs.TabRects.append(TabRect);
+		if (!Tab->isHidden())
+		{
+			Tabs.TabExtents.append(i, TabRect.left(), TabRect.left() + TabRect.width());
+		}
+	}
+	return Tabs;
+}
+
+
+/**
+ * Captures the tab geometries of the given auto hide side bar
+ */
+static DockDragTabsTarget captureTabs(CAutoHideSideBar* SideBar)
+{
+	DockDragTabsTarget Tabs;
+	Tabs.Visible = SideBar->isVisible();
+	Tabs.Orientation = SideBar->orientation();
+	Tabs.Origin = SideBar->mapToGlobal(QPoint(0, 0));
+	Tabs.TabRects.reserve(SideBar->count());
+	Tabs.TabExtents.reset(SideBar->count());
+	for (int i = 0; i < SideBar->count(); ++i)
+	{
+		auto Tab = SideBar->tab(i);
+		const QRect TabRect = Tab ? Tab->geometry() : QRect();
+		Tabs.TabRects.append(TabRect);
+		if (!Tab || Tab->isHidden())
+		{
+			continue;
+		}
+		if (Tabs.Orientation == Qt::Horizontal)
+		{
+			Tabs.TabExtents.append(i, TabRect.left(), TabRect.left() + TabRect.width());
+		}
+		else
+		{
+			Tabs.TabExtents.append(i, TabRect.top(), TabRect.top() + TabRect.height());
+		}
+	}
+	return Tabs;
+}
+
+
+//============================================================================
+int DockDragTabsTarget::tabInsertIndexAt(const QPoint& GlobalPos) const
+{
+	if (!Visible || TabRects.isEmpty())
+	{
+		return TabDefaultInsertIndex;
+	}
+
+	const QPoint Pos = GlobalPos - Origin;
+	const QRect& FirstTab = TabRects.first();
+	if ((Orientation == Qt::Horizontal) ? (Pos.x() < FirstTab.x()) : (Pos.y() < FirstTab.y()))
+	{
+		return 0;
+	}
+
+	int Index = TabExtents.indexAt((Orientation == Qt::Horizontal) ? Pos.x() : Pos.y());
+	if (Index >= 0 && TabRects[Index].contains(Pos))
+	{
+		return Index;
+	}
+
+	return TabRects.count();
+}
+
+
+//============================================================================
+const DockDragAreaTarget* DockDragContainerTarget::dockAreaAt(const QPoint& GlobalPos) const
+{
+	for (const auto& DockArea : DockAreas)
+	{
+		if (DockArea.Rect.contains(GlobalPos))
+		{
+			return &DockArea;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+void CDockDragSnapshot::capture(CDockManager* DockManager, CDockContainerWidget* ExcludedContainer)
+{
+	Containers.clear();
+	this->DockManager = DockManager;
+	if (!DockManager)
+	{
+		return;
+	}
+
+	Generation = DockManager->stateGeneration();
+
+	for (auto Container : DockManager->dockContainers())
+	{
+		if (Container == ExcludedContainer || !Container->isVisible())
+		{
+			continue;
+		}
+
+		DockDragContainerTarget Target;
+		Target.Container = Container;
+		Target.Rect = QRect(Container->mapToGlobal(QPoint(0, 0)), Container->size());
+		Target.VisibleDockAreaCount = Container->visibleDockAreaCount();
+		for (int i = 0; i < Container->dockAreaCount(); ++i)
+		{
+			auto DockArea = Container->dockArea(i);
+			if (!DockArea || !DockArea->isVisible())
+			{
+				continue;
+			}
+
+			DockDragAreaTarget AreaTarget;
+			AreaTarget.DockArea = DockArea;
+			AreaTarget.Rect = QRect(DockArea->mapToGlobal(QPoint(0, 0)), DockArea->size());
+			AreaTarget.AllowedAreas = DockArea->allowedAreas();
+			AreaTarget.TitleBarVisible = !DockArea->titleBar()->isHidden();
+			AreaTarget.TitleBarRect = DockArea->titleBarGeometry().translated(AreaTarget.Rect.topLeft());
+			AreaTarget.Tabs = captureTabs(DockArea->titleBar()->tabBar());
+			Target.DockAreas.append(AreaTarget);
+		}
+
+		for (int i = 0; i < SideBarNone; ++i)
+		{
+			auto SideBar = Container->autoHideSideBar(static_cast<SideBarLocation>(i));
+			if (!SideBar || !SideBar->isVisibleTo(Container))
+			{
+				Target.SideBarSizes[i] = 0;
+				continue;
+			}
+
+			Target.SideBarSizes[i] = (SideBar->orientation() == Qt::Horizontal)
+				? SideBar->height() : SideBar->width();
+			Target.SideBarTabs[i] = captureTabs(SideBar);
+		}
+		Containers.append(Target);
+	}
+
+	std::stable_sort(Containers.begin(), Containers.end(),
+		[](const DockDragContainerTarget& a, const DockDragContainerTarget& b)
+		{
+			return a.Container->isInFrontOf(b.Container);
+		});
+}
+
+
+//============================================================================
+bool CDockDragSnapshot::isOutdated() const
+{
+	return !DockManager || DockManager->stateGeneration() != Generation;
+}
+
+
+//============================================================================
+const DockDragContainerTarget* CDockDragSnapshot::containerAt(const QPoint& GlobalPos) const
+{
+	for (const auto& Container : Containers)
+	{
+		if (Container.Container && Container.Rect.contains(GlobalPos))
+		{
+			return &Container;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+const DockDragContainerTarget* CDockDragSnapshot::container(const QWidget* Container) const
+{
+	for (const auto& Target : Containers)
+	{
+		if (Target.Container == Container)
+		{
+			return &Target;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+const DockDragAreaTarget* CDockDragSnapshot::dockArea(const QWidget* DockArea) const
+{
+	for (const auto& Container : Containers)
+	{
+		for (const auto& Target : Container.DockAreas)
+		{
+			if (Target.DockArea == DockArea)
+			{
+				return &Target;
+			}
+		}
+	}
+
+	return nullptr;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockDragSnapshot.cpp
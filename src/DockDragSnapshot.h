@@ -0,0 +1,128 @@
+#ifndef DockDragSnapshotH
+#define DockDragSnapshotH
+//============================================================================
+/// \file   DockDragSnapshot.h
+/// \date   16.10.2026
+/// \brief  Declaration of CDockDragSnapshot
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QPointer>
+#include <QRect>
+#include <QVector>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+class CDockManager;
+class CDockContainerWidget;
+class CDockAreaWidget;
+
+/**
+ * Tab bar or auto hide side bar tabs captured by CDockDragSnapshot.
+ * The tab geometries are stored relative to the global Origin
+ */
+struct DockDragTabsTarget
+{
+	bool Visible = false;
+	Qt::Orientation Orientation = Qt::Horizontal;
+	QPoint Origin;
+	QVector<QRect> TabRects;
+	internal::CTabExtents TabExtents; ///< extents of the visible tabs
+
+	/**
+	 * Returns the same like tabInsertIndexAt() of the tab bar or side bar
+	 * for the given global position
+	 */
+	int tabInsertIndexAt(const QPoint& GlobalPos) const;
+};
+
+
+/**
+ * Dock area captured by CDockDragSnapshot
+ */
+struct DockDragAreaTarget
+{
+	QPointer<CDockAreaWidget> DockArea;
+	QRect Rect; ///< global geometry of the dock area
+	DockWidgetAreas AllowedAreas;
+	bool TitleBarVisible = false;
+	QRect TitleBarRect; ///< global geometry of the title bar
+	DockDragTabsTarget Tabs;
+};
+
+
+/**
+ * Dock container captured by CDockDragSnapshot
+ */
+struct DockDragContainerTarget
+{
+	QPointer<CDockContainerWidget> Container;
+	QRect Rect; ///< global geometry of the container
+	int VisibleDockAreaCount = 0;
+	QVector<DockDragAreaTarget> DockAreas; ///< all visible dock areas
+	int SideBarSizes[SideBarNone]; ///< size of each side bar or 0 if it is hidden
+	DockDragTabsTarget SideBarTabs[SideBarNone];
+
+	/**
+	 * Returns the visible dock area at the given global position or
+	 * nullptr, if there is no dock area
+	 */
+	const DockDragAreaTarget* dockAreaAt(const QPoint& GlobalPos) const;
+};
+
+
+/**
+ * Snapshot of all drop targets of the dock manager. The snapshot is taken
+ * once, when a drag operation starts. The drop target under the cursor is
+ * resolved for each mouse move with plain geometry tests on the snapshot
+ * instead of querying and mapping the widgets again.
+ * The snapshot becomes outdated, if the layout changes - e.g. if the dragged
+ * dock widget has been removed from its dock area - so the drag sources
+ * check isOutdated() and capture a new snapshot if required.
+ */
+class CDockDragSnapshot
+{
+private:
+	QVector<DockDragContainerTarget> Containers; ///< sorted from front to back
+	QPointer<CDockManager> DockManager;
+	quint64 Generation = 0; ///< state generation of the dock manager at capture time
+
+public:
+	/**
+	 * Captures all visible containers of the given dock manager except the
+	 * ExcludedContainer - that is the container that is dragged
+	 */
+	void capture(CDockManager* DockManager, CDockContainerWidget* ExcludedContainer = nullptr);
+
+	/**
+	 * Returns true, if the layout of the dock manager changed since the
+	 * snapshot has been captured and the snapshot needs to be captured again
+	 */
+	bool isOutdated() const;
+
+	/**
+	 * Returns the front most container at the given global position or
+	 * nullptr, if there is no container
+	 */
+	const DockDragContainerTarget* containerAt(const QPoint& GlobalPos) const;
+
+	/**
+	 * Returns the captured data of the given container or nullptr, if it is
+	 * not part of this snapshot
+	 */
+	const DockDragContainerTarget* container(const QWidget* Container) const;
+
+	/**
+	 * Returns the captured data of the given dock area or nullptr, if it is
+	 * not part of this snapshot
+	 */
+	const DockDragAreaTarget* dockArea(const QWidget* DockArea) const;
+}; // class CDockDragSnapshot
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockDragSnapshotH
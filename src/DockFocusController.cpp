@@ -68,19 +68,29 @@ struct DockFocusControllerPrivate
 //===========================================================================
 static void updateDockWidgetFocusStyle(CDockWidget* DockWidget, bool Focused)
 {
+	// Repolishing is expensive, so we skip it if the focus state does not
+	// change - e.g. if the focus moves between widgets of the same dock widget
+	if (DockWidget->property("focused").toBool() == Focused)
+	{
+		return;
+	}
 	DockWidget->setProperty("focused", Focused);
 	DockWidget->tabWidget()->setProperty("focused", Focused);
 	DockWidget->tabWidget()->updateStyle();
-	internal::repolishStyle(DockWidget);
+	internal::scheduleRepolishStyle(DockWidget);
 }
 
 
 //===========================================================================
 static void updateDockAreaFocusStyle(CDockAreaWidget* DockArea, bool Focused)
 {
+	if (DockArea->property("focused").toBool() == Focused)
+	{
+		return;
+	}
 	DockArea->setProperty("focused", Focused);
-	internal::repolishStyle(DockArea);
-	internal::repolishStyle(DockArea->titleBar());
+	internal::scheduleRepolishStyle(DockArea);
+	internal::scheduleRepolishStyle(DockArea->titleBar());
 }
 
 
@@ -97,6 +107,10 @@ static void updateFloatingWidgetFocusStyle(CFloatingDockContainer* FloatingWidge
     {
         return;
     }
+    if (TitleBar->property("focused").toBool() == Focused)
+    {
+        return;
+    }
     TitleBar->setProperty("focused", Focused);
     TitleBar->updateStyle();
 }
@@ -133,7 +147,7 @@ void DockFocusControllerPrivate::updateDockWidgetFocus(CDockWidget* DockWidget)
         Window->setProperty(FocusedDockWidgetProperty, QVariant::fromValue(QPointer<CDockWidget>(DockWidget)));
 	}
 	CDockAreaWidget* NewFocusedDockArea = nullptr;
-	if (FocusedDockWidget)
+	if (FocusedDockWidget && FocusedDockWidget != DockWidget)
 	{
 		updateDockWidgetFocusStyle(FocusedDockWidget, false);
 	}
@@ -154,6 +168,12 @@ void DockFocusControllerPrivate::updateDockWidgetFocus(CDockWidget* DockWidget)
 		updateDockAreaFocusStyle(FocusedArea, true);
 		QObject::connect(FocusedArea, SIGNAL(viewToggled(bool)), _this, SLOT(onFocusedDockAreaViewToggled(bool)));
 	}
+	else if (NewFocusedDockArea)
+	{
+		// A dock area from the widget pool may still be the focused area of
+		// its previous use, but its focus style has been reset
+		updateDockAreaFocusStyle(NewFocusedDockArea, true);
+	}
 
 
 
@@ -38,24 +38,41 @@
 #include <QMainWindow>
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QVariant>
 #include <QDebug>
 #include <QFile>
 #include <QAction>
-#include <QXmlStreamWriter>
 #include <QSettings>
 #include <QMenu>
 #include <QApplication>
 #include <QWindow>
 #include <QWindowStateChangeEvent>
+#include <QTimer>
+#include <QtEndian>
+#include <QBuffer>
+#include <QHash>
+
+#include <array>
+#include <limits>
+
+#ifdef ADS_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef ADS_HAS_LZ4
+#include <lz4.h>
+#endif
 
 #include "FloatingDockContainer.h"
+#include "FloatingDragPreview.h"
 #include "DockOverlay.h"
 #include "DockWidget.h"
 #include "ads_globals.h"
 #include "DockAreaWidget.h"
 #include "IconProvider.h"
 #include "DockingStateReader.h"
+#include "DockPerspectiveStore.h"
 #include "DockAreaTitleBar.h"
 #include "DockFocusController.h"
 #include "DockSplitter.h"
@@ -82,20 +99,554 @@ static void initResource()
 
 namespace ads
 {
+static CDockManager::ConfigFlags StaticConfigFlags = CDockManager::DefaultNonOpaqueConfig;
+static CDockManager::AutoHideFlags StaticAutoHideConfigFlags; // auto hide feature is disabled by default
+static std::array<QVariant, CDockManager::ConfigParamCount> StaticConfigParams;
+
+static QString FloatingContainersTitle;
+
+
+/**
+ * Data compressed with a codec other than ZlibCodec starts with this magic
+ * header followed by the codec and the size of the uncompressed data. Data
+ * compressed with ZlibCodec has no header to stay compatible with older
+ * versions.
+ */
+static const char CompressedMagic[] = {'A', 'D', 'S', 'Z'};
+static const int CompressedMagicSize = sizeof(CompressedMagic);
+static const int CompressedHeaderSize = CompressedMagicSize + 1 + int(sizeof(quint32));
+
+
 /**
- * Internal file version in case the structure changes internally
+ * Returns the codec from the CompressionCodec config parameter or
+ * FastZlibCodec, if the configured codec is not available
  */
-enum eStateFileVersion
+static CDockManager::eCompressionCodec compressionCodec()
 {
-	InitialVersion = 0,      //!< InitialVersion
-	Version1 = 1,            //!< Version1
-	CurrentVersion = Version1//!< CurrentVersion
-};
+	auto Codec = static_cast<CDockManager::eCompressionCodec>(CDockManager::configParam(
+		CDockManager::CompressionCodec, CDockManager::ZlibCodec).toInt());
+	return CDockManager::isCompressionCodecAvailable(Codec) ? Codec : CDockManager::FastZlibCodec;
+}
 
-static CDockManager::ConfigFlags StaticConfigFlags = CDockManager::DefaultNonOpaqueConfig;
-static CDockManager::AutoHideFlags StaticAutoHideConfigFlags; // auto hide feature is disabled by default
 
-static QString FloatingContainersTitle;
+/**
+ * Compresses the given state data with the configured compression codec
+ */
+static QByteArray compressStateData(const QByteArray& Data)
+{
+	auto Codec = compressionCodec();
+	if (CDockManager::ZlibCodec == Codec)
+	{
+		return qCompress(Data, 9);
+	}
+
+	QByteArray Result(CompressedHeaderSize, Qt::Uninitialized);
+	memcpy(Result.data(), CompressedMagic, CompressedMagicSize);
+	Result[CompressedMagicSize] = char(Codec);
+	qToBigEndian<quint32>(Data.size(),
+		reinterpret_cast<uchar*>(Result.data() + CompressedMagicSize + 1));
+
+	switch (Codec)
+	{
+#ifdef ADS_HAS_ZSTD
+	case CDockManager::ZstdCodec:
+		{
+			Result.resize(CompressedHeaderSize + int(ZSTD_compressBound(Data.size())));
+			auto CompressedSize = ZSTD_compress(Result.data() + CompressedHeaderSize,
+				Result.size() - CompressedHeaderSize, Data.constData(), Data.size(), 1);
+			if (ZSTD_isError(CompressedSize))
+			{
+				return QByteArray();
+			}
+			Result.resize(CompressedHeaderSize + int(CompressedSize));
+		}
+		break;
+#endif
+
+#ifdef ADS_HAS_LZ4
+	case CDockManager::Lz4Codec:
+		{
+			Result.resize(CompressedHeaderSize + LZ4_compressBound(Data.size()));
+			int CompressedSize = LZ4_compress_default(Data.constData(),
+				Result.data() + CompressedHeaderSize, Data.size(),
+				Result.size() - CompressedHeaderSize);
+			if (CompressedSize <= 0)
+			{
+				return QByteArray();
+			}
+			Result.resize(CompressedHeaderSize + CompressedSize);
+		}
+		break;
+#endif
+
+	default:
+		Result.append(qCompress(Data, 1));
+		break;
+	}
+
+	return Result;
+}
+
+
+#if defined(ADS_HAS_ZSTD) || defined(ADS_HAS_LZ4)
+/**
+ * Returns the uncompressed size from the header of data compressed with a
+ * codec other than ZlibCodec
+ */
+static int uncompressedSize(const QByteArray& Data)
+{
+	auto Size = qFromBigEndian<quint32>(
+		reinterpret_cast<const uchar*>(Data.constData() + CompressedMagicSize + 1));
+	// Corrupted data must not cause huge allocations
+	return (Size > quint32(std::numeric_limits<int>::max() / 2)) ? 0 : int(Size);
+}
+#endif
+
+
+/**
+ * Uncompresses data created by compressStateData(). Returns an empty byte
+ * array, if the data is invalid or if it has been compressed with a codec
+ * that is not available.
+ */
+static QByteArray uncompressStateData(const QByteArray& Data)
+{
+	if (!Data.startsWith(QByteArray::fromRawData(CompressedMagic, CompressedMagicSize)))
+	{
+		return qUncompress(Data);
+	}
+
+	if (Data.size() < CompressedHeaderSize)
+	{
+		return QByteArray();
+	}
+
+	auto Codec = static_cast<uchar>(Data[CompressedMagicSize]);
+	switch (Codec)
+	{
+	case CDockManager::FastZlibCodec:
+		return qUncompress(reinterpret_cast<const uchar*>(Data.constData()) + CompressedHeaderSize,
+			Data.size() - CompressedHeaderSize);
+
+#ifdef ADS_HAS_ZSTD
+	case CDockManager::ZstdCodec:
+		{
+			auto Size = uncompressedSize(Data);
+			QByteArray Result(Size, Qt::Uninitialized);
+			auto UncompressedSize = ZSTD_decompress(Result.data(), Size,
+				Data.constData() + CompressedHeaderSize, Data.size() - CompressedHeaderSize);
+			return (ZSTD_isError(UncompressedSize) || UncompressedSize != size_t(Size))
+				? QByteArray() : Result;
+		}
+#endif
+
+#ifdef ADS_HAS_LZ4
+	case CDockManager::Lz4Codec:
+		{
+			auto Size = uncompressedSize(Data);
+			QByteArray Result(Size, Qt::Uninitialized);
+			int UncompressedSize = LZ4_decompress_safe(Data.constData() + CompressedHeaderSize,
+				Result.data(), Data.size() - CompressedHeaderSize, Size);
+			return (UncompressedSize != Size) ? QByteArray() : Result;
+		}
+#endif
+
+	default:
+		qWarning() << "Saved state has been compressed with unsupported codec" << Codec;
+		return QByteArray();
+	}
+}
+
+
+/**
+ * States that are saved into a QIODevice with enabled compression start
+ * with this magic header followed by compressed chunks. Each chunk is
+ * stored as 32 bit size followed by the data created by compressStateData().
+ * A chunk with size 0 marks the end of the data.
+ */
+static const char ChunkedMagic[] = {'A', 'D', 'S', 'C'};
+static const int ChunkedMagicSize = sizeof(ChunkedMagic);
+static const int CompressionChunkSize = 64 * 1024;
+
+
+/**
+ * Reads exactly Size bytes from the given device. The state is only read
+ * from random access devices, so the function never needs to wait for data.
+ */
+static bool readExactly(QIODevice* Device, char* Data, qint64 Size)
+{
+	return Device->read(Data, Size) == Size;
+}
+
+
+/**
+ * Sequential device that compresses the written data chunk by chunk into
+ * a target device or that uncompresses the chunks read from a source
+ * device. So only one chunk of the data is kept in memory.
+ */
+class CChunkedCompressionDevice : public QIODevice
+{
+private:
+	QIODevice* m_Device;
+	QByteArray m_Chunk;
+	int m_ChunkPos = 0;
+	bool m_AtEnd = false;
+	bool m_Error = false;
+
+	/**
+	 * Writes the given compressed chunk with its size
+	 */
+	bool writeChunk(const QByteArray& Chunk)
+	{
+		uchar Size[sizeof(quint32)];
+		qToBigEndian<quint32>(Chunk.size(), Size);
+		m_Error |= m_Device->write(reinterpret_cast<const char*>(Size), sizeof(Size)) != qint64(sizeof(Size))
+			|| m_Device->write(Chunk) != Chunk.size();
+		return !m_Error;
+	}
+
+	/**
+	 * Compresses and writes the buffered data
+	 */
+	bool flushChunk()
+	{
+		if (m_Chunk.isEmpty())
+		{
+			return true;
+		}
+
+		auto Compressed = compressStateData(m_Chunk);
+		m_Chunk.clear();
+		m_Error |= Compressed.isEmpty();
+		return !m_Error && writeChunk(Compressed);
+	}
+
+	/**
+	 * Reads and uncompresses the next chunk
+	 */
+	bool readChunk()
+	{
+		uchar SizeData[sizeof(quint32)];
+		if (!readExactly(m_Device, reinterpret_cast<char*>(SizeData), sizeof(SizeData)))
+		{
+			m_Error = true;
+			return false;
+		}
+
+		auto Size = qFromBigEndian<quint32>(SizeData);
+		m_ChunkPos = 0;
+		if (!Size)
+		{
+			m_Chunk.clear();
+			m_AtEnd = true;
+			return false;
+		}
+
+		// A compressed chunk is never much larger than the uncompressed chunk
+		QByteArray Compressed(CompressionChunkSize * 2, Qt::Uninitialized);
+		if (Size > quint32(Compressed.size())
+		 || !readExactly(m_Device, Compressed.data(), Size))
+		{
+			m_Error = true;
+			return false;
+		}
+
+		Compressed.resize(Size);
+		m_Chunk = uncompressStateData(Compressed);
+		m_Error = m_Chunk.isEmpty();
+		return !m_Error;
+	}
+
+public:
+	/**
+	 * Creates a device that writes to or reads from the given device
+	 */
+	CChunkedCompressionDevice(QIODevice* Device) :
+		m_Device(Device)
+	{
+	}
+
+	/**
+	 * Closes the device - this writes the remaining data
+	 */
+	virtual ~CChunkedCompressionDevice()
+	{
+		close();
+	}
+
+	/**
+	 * Returns true, if Data starts with the header of a chunked stream
+	 */
+	static bool isChunkedData(const QByteArray& Data)
+	{
+		return Data.startsWith(QByteArray::fromRawData(ChunkedMagic, ChunkedMagicSize));
+	}
+
+	/**
+	 * Writes or reads and checks the magic header
+	 */
+	virtual bool open(OpenMode Mode) override
+	{
+		if (Mode & WriteOnly)
+		{
+			if (m_Device->write(ChunkedMagic, ChunkedMagicSize) != ChunkedMagicSize)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			char Magic[ChunkedMagicSize];
+			if (!readExactly(m_Device, Magic, ChunkedMagicSize)
+			 || !isChunkedData(QByteArray::fromRawData(Magic, ChunkedMagicSize)))
+			{
+				return false;
+			}
+		}
+
+		return QIODevice::open(Mode);
+	}
+
+	/**
+	 * Writes the remaining data and the end marker if the device is opened
+	 * for writing
+	 */
+	virtual void close() override
+	{
+		if (!isOpen())
+		{
+			return;
+		}
+
+		if (openMode() & WriteOnly)
+		{
+			flushChunk();
+			writeChunk(QByteArray());
+		}
+		QIODevice::close();
+	}
+
+	virtual bool isSequential() const override
+	{
+		return true;
+	}
+
+	/**
+	 * Returns true, if reading, writing or the compression failed
+	 */
+	bool hasError() const
+	{
+		return m_Error;
+	}
+
+protected:
+	virtual qint64 readData(char* Data, qint64 MaxSize) override
+	{
+		qint64 BytesRead = 0;
+		while (BytesRead < MaxSize)
+		{
+			if (m_ChunkPos >= m_Chunk.size())
+			{
+				if (m_AtEnd || m_Error || !readChunk())
+				{
+					break;
+				}
+				continue;
+			}
+
+			auto Count = qMin<qint64>(MaxSize - BytesRead, m_Chunk.size() - m_ChunkPos);
+			memcpy(Data + BytesRead, m_Chunk.constData() + m_ChunkPos, Count);
+			m_ChunkPos += Count;
+			BytesRead += Count;
+		}
+
+		return (!BytesRead && m_Error) ? -1 : BytesRead;
+	}
+
+	virtual qint64 writeData(const char* Data, qint64 Size) override
+	{
+		qint64 BytesWritten = 0;
+		while (BytesWritten < Size)
+		{
+			auto Count = qMin<qint64>(Size - BytesWritten, CompressionChunkSize - m_Chunk.size());
+			m_Chunk.append(Data + BytesWritten, int(Count));
+			BytesWritten += Count;
+			if (m_Chunk.size() >= CompressionChunkSize && !flushChunk())
+			{
+				return -1;
+			}
+		}
+
+		return Size;
+	}
+}; // class CChunkedCompressionDevice
+
+
+/**
+ * Parses the uncompressed XML or binary state from the given device.
+ * Returns true only for a state with valid layout trees, so the parsed state
+ * can be restored without any further structural checks.
+ */
+static bool readUncompressedStateData(QIODevice* Device, DockingState& State)
+{
+	bool Parsed;
+	if (DockingState::isBinary(Device->peek(4)))
+	{
+		Parsed = DockingState::fromBinary(Device, State);
+	}
+	else
+	{
+		CDockingStateReader s(Device);
+		Parsed = s.readState(State);
+	}
+
+	return Parsed && State.isValid();
+}
+
+
+/**
+ * Uncompresses the remaining data of the given device that has been
+ * compressed as a whole. The compressed data of files and buffers is
+ * accessed in place, so only the uncompressed copy is held in memory.
+ */
+static QByteArray uncompressDeviceData(QIODevice* Device)
+{
+	auto Size = Device->size() - Device->pos();
+	if (Size > std::numeric_limits<int>::max())
+	{
+		return QByteArray();
+	}
+
+	auto Buffer = qobject_cast<QBuffer*>(Device);
+	if (Buffer)
+	{
+		return uncompressStateData(QByteArray::fromRawData(
+			Buffer->data().constData() + Buffer->pos(), int(Size)));
+	}
+
+	auto File = qobject_cast<QFileDevice*>(Device);
+	auto Mapped = File ? File->map(File->pos(), Size) : nullptr;
+	if (Mapped)
+	{
+		auto Data = uncompressStateData(QByteArray::fromRawData(
+			reinterpret_cast<const char*>(Mapped), int(Size)));
+		File->unmap(Mapped);
+		return Data;
+	}
+
+	return uncompressStateData(Device->readAll());
+}
+
+
+/**
+ * Parses the saved state from the given random access device into State.
+ * The function detects compressed data and the XML and binary format.
+ * Uncompressed and chunked compressed data is parsed while it is read from
+ * the device.
+ */
+static bool readStateData(QIODevice* Device, DockingState& State)
+{
+	auto Header = Device->peek(5);
+	if (CChunkedCompressionDevice::isChunkedData(Header))
+	{
+		CChunkedCompressionDevice Uncompressed(Device);
+		return Uncompressed.open(QIODevice::ReadOnly)
+			&& readUncompressedStateData(&Uncompressed, State)
+			&& !Uncompressed.hasError();
+	}
+
+	if (Header.startsWith("<?xml") || DockingState::isBinary(Header))
+	{
+		return readUncompressedStateData(Device, State);
+	}
+
+	// Data compressed by saveState() into a QByteArray needs to be
+	// uncompressed as a whole
+	QByteArray Data = uncompressDeviceData(Device);
+	if (Data.isEmpty())
+	{
+		return false;
+	}
+
+	QBuffer Buffer(&Data);
+	Buffer.open(QIODevice::ReadOnly);
+	return readUncompressedStateData(&Buffer, State);
+}
+
+
+/**
+ * Parses the given saved state data into State. The function detects
+ * compressed data and the XML and binary format.
+ */
+static bool readStateData(const QByteArray& Data, DockingState& State)
+{
+	QBuffer Buffer;
+	Buffer.setData(Data);
+	Buffer.open(QIODevice::ReadOnly);
+	return readStateData(&Buffer, State);
+}
+
+
+/**
+ * Writes the given state in the given format into the given device
+ * without compression
+ */
+static bool writeUncompressedStateData(const DockingState& State,
+	CDockManager::eStateFormat Format, QIODevice* Device)
+{
+	return (Format == CDockManager::BinaryStateFormat)
+		? State.writeBinary(Device)
+		: State.writeXml(Device, CDockManager::testConfigFlag(CDockManager::XmlAutoFormattingEnabled));
+}
+
+
+/**
+ * Serializes the given state into the given format and compresses the data
+ * with the configured codec if XmlCompressionEnabled is set
+ */
+static QByteArray writeStateData(const DockingState& State, CDockManager::eStateFormat Format)
+{
+	QByteArray Data;
+	QBuffer Buffer(&Data);
+	Buffer.open(QIODevice::WriteOnly);
+	writeUncompressedStateData(State, Format, &Buffer);
+	Buffer.close();
+	return CDockManager::testConfigFlag(CDockManager::XmlCompressionEnabled)
+		? compressStateData(Data) : Data;
+}
+
+
+/**
+ * Writes the given state in the given format into the given device. If
+ * XmlCompressionEnabled is set, the data is compressed chunk by chunk while
+ * it is written.
+ */
+static bool writeStateData(const DockingState& State, CDockManager::eStateFormat Format,
+	QIODevice* Device)
+{
+	if (!CDockManager::testConfigFlag(CDockManager::XmlCompressionEnabled))
+	{
+		return writeUncompressedStateData(State, Format, Device);
+	}
+
+	CChunkedCompressionDevice Compressed(Device);
+	if (!Compressed.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	bool Result = writeUncompressedStateData(State, Format, &Compressed);
+	Compressed.close();
+	return Result && !Compressed.hasError();
+}
+
+/**
+ * The state of a dock container captured by saveStateIncremental()
+ */
+struct CachedContainerState
+{
+	quint64 Generation = 0; ///< layout generation of the container for State
+	DockContainerState State;
+};
 
 /**
  * Private data class of CDockManager class (pimpl)
@@ -109,11 +660,12 @@ struct DockManagerPrivate
 	CDockOverlay* ContainerOverlay;
 	CDockOverlay* DockAreaOverlay;
 	QMap<QString, CDockWidget*> DockWidgetsMap;
-	QMap<QString, QByteArray> Perspectives;
+	CDockPerspectiveStore Perspectives;
 	QMap<QString, QMenu*> ViewMenuGroups;
 	QMenu* ViewMenu;
 	CDockManager::eViewMenuInsertionOrder MenuInsertionOrder = CDockManager::MenuAlphabeticallySorted;
 	bool RestoringState = false;
+	QSet<CDockContainerWidget*> UpdatedContainers; ///< containers that are updated in place during restore
 	QVector<CFloatingDockContainer*> UninitializedFloatingWidgets;
 	CDockFocusController* FocusController = nullptr;
     CDockWidget* CentralWidget = nullptr;
@@ -123,6 +675,19 @@ struct DockManagerPrivate
 	QSize ToolBarIconSizeDocked = QSize(16, 16);
 	QSize ToolBarIconSizeFloating = QSize(24, 24);
 	CDockWidget::DockWidgetFeatures LockedDockWidgetFeatures;
+	QList<QPointer<CDockAreaWidget>> DockAreaPool; ///< empty dock areas for reuse
+	QList<QPointer<CDockSplitter>> SplitterPool; ///< empty splitters for reuse
+	QList<QPointer<QWidget>> RecycledWidgets; ///< widgets that are added to the pools in the next event loop cycle
+	QWidget* PoolParent = nullptr; ///< hidden parent of all recycled and pooled widgets
+	QPointer<CFloatingDragPreview> DragPreview; ///< reused for all non opaque drag operations
+	bool RecycledWidgetsPending = false;
+	QHash<const CDockContainerWidget*, CachedContainerState> ContainerStateCache;
+	quint64 StateGeneration = 0; ///< generation of changes not covered by the container generations
+	bool BatchingSignals = false; ///< true while restore signals are collected for batchedStateChanges()
+	QSet<CDockWidget*> BatchedViewToggles;
+	QSet<CDockWidget*> BatchedTopLevelChanges;
+	QSet<CDockContainerWidget*> BatchedAddedDockAreas;
+	QSet<CDockContainerWidget*> BatchedRemovedDockAreas;
 
 	/**
 	 * Private data constructor
@@ -130,20 +695,71 @@ struct DockManagerPrivate
 	DockManagerPrivate(CDockManager* _public);
 
 	/**
-	 * Checks if the given data stream is a valid docking system state
-	 * file.
+	 * Returns the max. size of the widget pools
+	 */
+	static int widgetPoolSize()
+	{
+		return CDockManager::configParam(CDockManager::WidgetPoolSize, 0).toInt();
+	}
+
+	/**
+	 * Moves the given widget into the hidden pool parent and schedules it for
+	 * adding it to the widget pools in the next event loop cycle
+	 */
+	void recycleWidget(QWidget* Widget);
+
+	/**
+	 * Moves the recycled widgets into the pools. Widgets that do not fit into
+	 * the pools anymore are deleted.
+	 */
+	void addRecycledWidgetsToPools();
+
+	/**
+	 * Checks if the given parsed state is a valid docking system state for
+	 * this dock manager. Nothing is modified by this function.
+	 */
+	bool checkState(const DockingState& State, int version) const;
+
+	/**
+	 * Restores the given state if it is a valid state for this dock manager
+	 * and emits the restore signals. If State is a nullptr, the state data
+	 * could not be parsed and only the signals are emitted.
 	 */
-	bool checkFormat(const QByteArray &state, int version);
+	bool restoreParsedState(const DockingState* State, int version);
 
 	/**
-	 * Restores the state
+	 * Applies the given parsed and validated state
 	 */
-	bool restoreStateFromXml(const QByteArray &state, int version, bool Testing = internal::Restore);
+	void applyState(const DockingState& State);
 
 	/**
-	 * Restore state
+	 * Captures the current layout of all dock containers into State
 	 */
-	bool restoreState(const QByteArray &state, int version);
+	void captureState(DockingState& State, int version) const;
+
+	/**
+	 * Captures the state like captureState() but reuses the cached state
+	 * of all containers, that have not changed since the last call
+	 */
+	void captureStateIncremental(DockingState& State, int version);
+
+	/**
+	 * Emits the batchedStateChanges() signal with all signals collected
+	 * during the restore and ends the batching
+	 */
+	void emitBatchedSignals();
+
+	/**
+	 * Collects all existing containers into UpdatedContainers, that are
+	 * updated in place to the given state instead of being rebuilt. These
+	 * are all containers, whose floating state matches the state.
+	 */
+	void findUpdatedContainers(const DockingState& State);
+
+	/**
+	 * Restore the given parsed state
+	 */
+	void restoreState(const DockingState& State);
 
 	void restoreDockWidgetsOpenState();
 	void restoreDockAreasIndices();
@@ -151,10 +767,11 @@ struct DockManagerPrivate
 
 	void hideFloatingWidgets()
 	{
-		// Hide updates of floating widgets from user
+		// Hide updates of floating widgets from user - floating widgets that
+		// are updated in place remain visible
 		for (auto FloatingWidget : FloatingWidgets)
 		{
-			if (FloatingWidget)
+			if (FloatingWidget && !UpdatedContainers.contains(FloatingWidget->dockContainer()))
 			{
 			  FloatingWidget->hide();
 			}
@@ -166,13 +783,14 @@ struct DockManagerPrivate
 		for (auto DockWidget : DockWidgetsMap)
 		{
 			DockWidget->setProperty(internal::DirtyProperty, true);
+			DockWidget->setProperty(internal::UnchangedProperty, false);
 		}
 	}
 
 	/**
 	 * Restores the container with the given index
 	 */
-	bool restoreContainer(int Index, CDockingStateReader& stream, bool Testing);
+	void restoreContainer(int Index, const DockContainerState& State);
 
 	/**
 	 * Loads the stylesheet
@@ -216,135 +834,256 @@ void DockManagerPrivate::loadStylesheet()
 
 
 //============================================================================
-bool DockManagerPrivate::restoreContainer(int Index, CDockingStateReader& stream, bool Testing)
+void DockManagerPrivate::restoreContainer(int Index, const DockContainerState& State)
 {
-	if (Testing)
-	{
-		Index = 0;
-	}
-
-	bool Result = false;
 	if (Index >= Containers.count())
 	{
 		CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(_this);
-		Result = FloatingWidget->restoreState(stream, Testing);
+		FloatingWidget->restoreState(State);
 	}
 	else
 	{
         ADS_PRINT("d->Containers[i]->restoreState ");
 		auto Container = Containers[Index];
-		if (Container->isFloating())
+		if (UpdatedContainers.contains(Container))
+		{
+			Container->updateState(State);
+			if (Container->isFloating())
+			{
+				// The dock areas of the floating widget may have changed
+				Container->floatingWidget()->onDockAreasAddedOrRemoved();
+			}
+		}
+		else if (Container->isFloating())
 		{
-			Result = Container->floatingWidget()->restoreState(stream, Testing);
+			Container->floatingWidget()->restoreState(State);
 		}
 		else
 		{
-			Result = Container->restoreState(stream, Testing);
+			Container->restoreState(State);
 		}
 	}
+}
 
-	return Result;
+
+//============================================================================
+bool DockManagerPrivate::checkState(const DockingState& State, int version) const
+{
+    ADS_PRINT(State.UserVersion);
+    if (State.HasUserVersion && State.UserVersion != version)
+    {
+    	return false;
+    }
+
+    ADS_PRINT(State.Containers.count());
+    if (CentralWidget)
+    {
+		// If we have a central widget but a state without central widget, then
+		// something is wrong.
+		if (State.CentralWidget.isEmpty())
+		{
+			qWarning() << "Dock manager has central widget but saved state does not have central widget.";
+			return false;
+		}
+
+		// If the object name of the central widget does not match the name of the
+		// saved central widget, the something is wrong
+		if (CentralWidget->objectName() != State.CentralWidget)
+		{
+			qWarning() << "Object name of central widget does not match name of central widget in saved state.";
+			return false;
+		}
+    }
+
+    return true;
 }
 
 
 //============================================================================
-bool DockManagerPrivate::checkFormat(const QByteArray &state, int version)
+bool DockManagerPrivate::restoreParsedState(const DockingState* State, int version)
 {
-    return restoreStateFromXml(state, version, internal::RestoreTesting);
+	// Prevent multiple calls as long as state is not restore. This may
+	// happen, if QApplication::processEvents() is called somewhere
+	if (RestoringState)
+	{
+		return false;
+	}
+
+	bool Result = State && checkState(*State, version);
+	if (Result)
+	{
+		findUpdatedContainers(*State);
+	}
+	else
+	{
+		ADS_PRINT("parseState: Error checking format!!!!!!!");
+	}
+
+	// We hide the complete dock manager here. Restoring the state means
+	// that DockWidgets are removed from the DockArea internal stack layout
+	// which in turn  means, that each time a widget is removed the stack
+	// will show and raise the next available widget which in turn
+	// triggers show events for the dock widgets. To avoid this we hide the
+	// dock manager. Because there will be no processing of application
+	// events until this function is finished, the user will not see this
+	// hiding. If the dock manager is updated in place, only the dock areas
+	// that change are hidden and we do not need to hide it.
+	bool Hide = !_this->isHidden() && !UpdatedContainers.contains(_this);
+	if (Hide)
+	{
+		_this->hide();
+	}
+	RestoringState = true;
+	BatchingSignals = CDockManager::testConfigFlag(CDockManager::BatchedRestoreSignals);
+	Q_EMIT _this->restoringState();
+	if (Result)
+	{
+		restoreState(*State);
+	}
+	RestoringState = false;
+	if (Hide)
+	{
+		_this->show();
+	}
+	emitBatchedSignals();
+	Q_EMIT _this->stateRestored();
+	return Result;
 }
 
 
 //============================================================================
-bool DockManagerPrivate::restoreStateFromXml(const QByteArray &state,  int version,
-	bool Testing)
+void DockManagerPrivate::applyState(const DockingState& State)
 {
-	Q_UNUSED(version);
+	// Dock widgets that move to another container need to leave their old
+	// dock area, before any container is updated
+	for (int i = 0; i < Containers.count() && i < State.Containers.count(); ++i)
+	{
+		if (UpdatedContainers.contains(Containers[i]))
+		{
+			Containers[i]->prepareStateUpdate(State.Containers[i]);
+		}
+	}
 
-    if (state.isEmpty())
-    {
-        return false;
-    }
-    CDockingStateReader s(state);
-    s.readNextStartElement();
-    if (s.name() != QLatin1String("QtAdvancedDockingSystem"))
-    {
-    	return false;
-    }
-    ADS_PRINT(s.attributes().value("Version"));
-    bool ok;
-    int v = s.attributes().value("Version").toInt(&ok);
-    if (!ok || v > CurrentVersion)
+    int DockContainerCount = 0;
+    for (const auto& Container : State.Containers)
     {
-    	return false;
+    	restoreContainer(DockContainerCount, Container);
+    	DockContainerCount++;
     }
-    s.setFileVersion(v);
 
-    ADS_PRINT(s.attributes().value("UserVersion"));
-    // Older files do not support UserVersion but we still want to load them so
-    // we first test if the attribute exists
-    if (!s.attributes().value("UserVersion").isEmpty())
-    {
-		v = s.attributes().value("UserVersion").toInt(&ok);
-		if (!ok || v != version)
+	// Delete remaining empty floating widgets
+	int FloatingWidgetIndex = DockContainerCount - 1;
+	for (int i = FloatingWidgetIndex; i < FloatingWidgets.count(); ++i)
+	{
+		CFloatingDockContainer* floatingWidget = FloatingWidgets[i];
+		if (!floatingWidget) continue;
+		_this->removeDockContainer(floatingWidget->dockContainer());
+		floatingWidget->deleteLater();
+	}
+}
+
+
+//============================================================================
+void DockManagerPrivate::captureState(DockingState& State, int version) const
+{
+	State.HasUserVersion = true;
+	State.UserVersion = version;
+	if (CentralWidget)
+	{
+		State.CentralWidget = CentralWidget->objectName();
+	}
+
+	State.Containers.resize(Containers.count());
+	for (int i = 0; i < Containers.count(); ++i)
+	{
+		Containers[i]->saveState(State.Containers[i]);
+	}
+}
+
+
+//============================================================================
+void DockManagerPrivate::captureStateIncremental(DockingState& State, int version)
+{
+	State.HasUserVersion = true;
+	State.UserVersion = version;
+	if (CentralWidget)
+	{
+		State.CentralWidget = CentralWidget->objectName();
+	}
+
+	State.Containers.resize(Containers.count());
+	for (int i = 0; i < Containers.count(); ++i)
+	{
+		auto Container = Containers[i];
+		auto& Cached = ContainerStateCache[Container];
+		if (Cached.Generation != Container->layoutGeneration())
 		{
-			return false;
+			Cached.State = DockContainerState();
+			Container->saveState(Cached.State);
+			Cached.Generation = Container->layoutGeneration();
 		}
-    }
+		else if (Cached.State.Floating)
+		{
+			// The window geometry is not tracked by the layout generation
+			Cached.State.Geometry = Container->floatingWidget()->saveGeometry();
+		}
+		State.Containers[i] = Cached.State;
+	}
+}
 
-    bool Result = true;
-#ifdef ADS_DEBUG_PRINT
-    int  DockContainers = s.attributes().value("Containers").toInt();
-#endif
-    ADS_PRINT(DockContainers);
 
-    if (CentralWidget)
-    {
-		const auto CentralWidgetAttribute = s.attributes().value("CentralWidget");
-		// If we have a central widget but a state without central widget, then
-		// something is wrong.
-		if (CentralWidgetAttribute.isEmpty())
+//============================================================================
+void DockManagerPrivate::emitBatchedSignals()
+{
+	if (!BatchingSignals)
+	{
+		return;
+	}
+
+	BatchingSignals = false;
+	DockRestoreChanges Changes;
+	for (auto DockWidget : BatchedViewToggles)
+	{
+		if (DockWidget->isClosed())
 		{
-			qWarning() << "Dock manager has central widget but saved state does not have central widget.";
-			return false;
+			Changes.ClosedDockWidgets.append(DockWidget);
 		}
-
-		// If the object name of the central widget does not match the name of the
-		// saved central widget, the something is wrong
-		if (CentralWidget->objectName() != CentralWidgetAttribute.toString())
+		else
 		{
-			qWarning() << "Object name of central widget does not match name of central widget in saved state.";
-			return false;
+			Changes.OpenedDockWidgets.append(DockWidget);
 		}
-    }
+	}
+	Changes.TopLevelChangedDockWidgets = BatchedTopLevelChanges.values();
 
-    int DockContainerCount = 0;
-    while (s.readNextStartElement())
-    {
-        if (s.name() == QLatin1String("Container"))
-    	{
-    		Result = restoreContainer(DockContainerCount, s, Testing);
-			if (!Result)
-			{
-				break;
-			}
-			DockContainerCount++;
-    	}
-    }
+	// Containers of floating widgets, that have been deleted during the
+	// restore, are not registered anymore and are not reported
+	for (auto DockContainer : Containers)
+	{
+		bool Added = BatchedAddedDockAreas.contains(DockContainer);
+		bool Removed = BatchedRemovedDockAreas.contains(DockContainer);
+		if (Added)
+		{
+			Changes.ContainersWithAddedDockAreas.append(DockContainer);
+		}
+		if (Removed)
+		{
+			Changes.ContainersWithRemovedDockAreas.append(DockContainer);
+		}
 
-    if (!Testing)
-    {
-		// Delete remaining empty floating widgets
-		int FloatingWidgetIndex = DockContainerCount - 1;
-		for (int i = FloatingWidgetIndex; i < FloatingWidgets.count(); ++i)
+		// The floating widget relies on the suppressed signals to update
+		// its window title
+		auto FloatingWidget = DockContainer->floatingWidget();
+		if (FloatingWidget && (Added || Removed))
 		{
-			CFloatingDockContainer* floatingWidget = FloatingWidgets[i];
-			if (!floatingWidget) continue;
-			_this->removeDockContainer(floatingWidget->dockContainer());
-			floatingWidget->deleteLater();
+			FloatingWidget->onDockAreasAddedOrRemoved();
 		}
-    }
+	}
 
-    return Result;
+	BatchedViewToggles.clear();
+	BatchedTopLevelChanges.clear();
+	BatchedAddedDockAreas.clear();
+	BatchedRemovedDockAreas.clear();
+	Q_EMIT _this->batchedStateChanges(Changes);
 }
 
 
@@ -366,11 +1105,22 @@ void DockManagerPrivate::restoreDockWidgetsOpenState()
     			DockWidget->autoHideDockContainer()->cleanupAndDelete();
     		}
     		DockWidget->flagAsUnassigned();
-            Q_EMIT DockWidget->viewToggled(false);
+    		if (!_this->deferViewToggled(DockWidget))
+    		{
+    			Q_EMIT DockWidget->viewToggled(false);
+    		}
     	}
     	else
     	{
-    		DockWidget->toggleViewInternal(!DockWidget->property(internal::ClosedProperty).toBool());
+    		// Dock widgets that stayed in their dock area during an in place
+    		// update only need to be toggled, if their closed state changed
+    		bool Closed = DockWidget->property(internal::ClosedProperty).toBool();
+    		if (DockWidget->isClosed() == Closed
+    		 && DockWidget->property(internal::UnchangedProperty).toBool())
+    		{
+    			continue;
+    		}
+    		DockWidget->toggleViewInternal(!Closed);
     	}
     }
 }
@@ -441,31 +1191,33 @@ void DockManagerPrivate::emitTopLevelEvents()
 
 
 //============================================================================
-bool DockManagerPrivate::restoreState(const QByteArray& State, int version)
+void DockManagerPrivate::findUpdatedContainers(const DockingState& State)
 {
-	QByteArray state = State.startsWith("<?xml") ? State : qUncompress(State);
-    if (!checkFormat(state, version))
-    {
-        ADS_PRINT("checkFormat: Error checking format!!!!!!!");
-    	return false;
-    }
+	UpdatedContainers.clear();
+	int Count = qMin(Containers.count(), State.Containers.count());
+	for (int i = 0; i < Count; ++i)
+	{
+		if (Containers[i]->isFloating() == State.Containers[i].Floating)
+		{
+			UpdatedContainers.insert(Containers[i]);
+		}
+	}
+}
+
 
+//============================================================================
+void DockManagerPrivate::restoreState(const DockingState& State)
+{
     // Hide updates of floating widgets from use
     hideFloatingWidgets();
     markDockWidgetsDirty();
-
-    if (!restoreStateFromXml(state, version))
-    {
-        ADS_PRINT("restoreState: Error restoring state!!!!!!!");
-    	return false;
-    }
+    applyState(State);
 
     restoreDockWidgetsOpenState();
     restoreDockAreasIndices();
     emitTopLevelEvents();
+    UpdatedContainers.clear();
     _this->dumpLayout();
-
-    return true;
 }
 
 
@@ -497,11 +1249,78 @@ void DockManagerPrivate::addActionToMenu(QAction* Action, QMenu* Menu, bool Inse
 }
 
 
+//============================================================================
+void DockManagerPrivate::recycleWidget(QWidget* Widget)
+{
+	if (!PoolParent)
+	{
+		PoolParent = new QWidget();
+	}
+
+	// The pool parent is never shown, so show() does not show the widget.
+	// It only clears an explicit hidden state from the previous use. So a
+	// pooled widget is shown like a new widget, when it is inserted into a
+	// visible splitter.
+	Widget->setParent(PoolParent);
+	Widget->show();
+
+	// The widget is added to the pool in the next event loop cycle. So it can
+	// not be reused while the caller still works with it - just like a
+	// widget that has been scheduled for deletion via deleteLater()
+	RecycledWidgets.append(Widget);
+	if (RecycledWidgetsPending)
+	{
+		return;
+	}
+
+	RecycledWidgetsPending = true;
+	QTimer::singleShot(0, _this, [this]()
+	{
+		addRecycledWidgetsToPools();
+	});
+}
+
+
+//============================================================================
+void DockManagerPrivate::addRecycledWidgetsToPools()
+{
+	RecycledWidgetsPending = false;
+	auto MaxPoolSize = widgetPoolSize();
+	auto Widgets = RecycledWidgets;
+	RecycledWidgets.clear();
+	for (auto Widget : Widgets)
+	{
+		if (!Widget)
+		{
+			continue;
+		}
+
+		auto DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+		if (DockArea && DockAreaPool.count() < MaxPoolSize)
+		{
+			DockAreaPool.append(DockArea);
+			continue;
+		}
+
+		auto Splitter = qobject_cast<CDockSplitter*>(Widget);
+		if (Splitter && SplitterPool.count() < MaxPoolSize)
+		{
+			SplitterPool.append(Splitter);
+			continue;
+		}
+
+		Widget->deleteLater();
+	}
+}
+
+
 //============================================================================
 CDockManager::CDockManager(QWidget *parent) :
 	CDockContainerWidget(this, parent),
 	d(new DockManagerPrivate(this))
 {
+	// Required for queued connections to the batchedStateChanges() signal
+	qRegisterMetaType<ads::DockRestoreChanges>();
 	createRootSplitter();
 	createSideTabBarWidgets();
 	QMainWindow* MainWindow = qobject_cast<QMainWindow*>(parent);
@@ -576,6 +1395,9 @@ CDockManager::~CDockManager()
 		delete area;
 	}
 
+	// Deletes all recycled and pooled widgets
+	delete d->PoolParent;
+
 	delete d;
 }
 
@@ -709,6 +1531,7 @@ void CDockManager::removeFloatingWidget(CFloatingDockContainer* FloatingWidget)
 void CDockManager::registerDockContainer(CDockContainerWidget* DockContainer)
 {
 	d->Containers.append(DockContainer);
+	d->StateGeneration = nextLayoutGeneration();
 }
 
 
@@ -718,6 +1541,8 @@ void CDockManager::removeDockContainer(CDockContainerWidget* DockContainer)
 	if (this != DockContainer)
 	{
 		d->Containers.removeAll(DockContainer);
+		d->ContainerStateCache.remove(DockContainer);
+		d->StateGeneration = nextLayoutGeneration();
 	}
 }
 
@@ -763,67 +1588,130 @@ unsigned int CDockManager::zOrderIndex() const
 
 
 //============================================================================
-QByteArray CDockManager::saveState(int version) const
+QByteArray CDockManager::saveState(int version, eStateFormat Format) const
 {
-    QByteArray xmldata;
-    QXmlStreamWriter s(&xmldata);
-    auto ConfigFlags = CDockManager::configFlags();
-	s.setAutoFormatting(ConfigFlags.testFlag(XmlAutoFormattingEnabled));
-    s.writeStartDocument();
-		s.writeStartElement("QtAdvancedDockingSystem");
-		s.writeAttribute("Version", QString::number(CurrentVersion));
-		s.writeAttribute("UserVersion", QString::number(version));
-		s.writeAttribute("Containers", QString::number(d->Containers.count()));
-		if (d->CentralWidget)
-		{
-			s.writeAttribute("CentralWidget", d->CentralWidget->objectName());
-		}
-		for (auto Container : d->Containers)
-		{
-			Container->saveState(s);
-		}
+	DockingState State;
+	d->captureState(State, version);
+	return writeStateData(State, Format);
+}
 
-		s.writeEndElement();
-    s.writeEndDocument();
 
-    return ConfigFlags.testFlag(XmlCompressionEnabled)
-    	? qCompress(xmldata, 9) : xmldata;
+//============================================================================
+bool CDockManager::saveState(QIODevice* Device, int version, eStateFormat Format) const
+{
+	DockingState State;
+	d->captureState(State, version);
+	return writeStateData(State, Format, Device);
 }
 
 
 //============================================================================
-bool CDockManager::restoreState(const QByteArray &state, int version)
+QByteArray CDockManager::saveStateIncremental(int version, eStateFormat Format) const
 {
-	// Prevent multiple calls as long as state is not restore. This may
-	// happen, if QApplication::processEvents() is called somewhere
-	if (d->RestoringState)
+	DockingState State;
+	d->captureStateIncremental(State, version);
+	return writeStateData(State, Format);
+}
+
+
+//============================================================================
+quint64 CDockManager::stateGeneration() const
+{
+	quint64 Generation = d->StateGeneration;
+	for (auto Container : d->Containers)
+	{
+		Generation = qMax(Generation, Container->layoutGeneration());
+	}
+	return Generation;
+}
+
+
+//============================================================================
+bool CDockManager::parseState(const QByteArray &state, DockingState& State)
+{
+	return readStateData(state, State);
+}
+
+
+//============================================================================
+bool CDockManager::parseState(QIODevice* Device, DockingState& State)
+{
+	// The XML and binary readers require, that the complete data is
+	// available. A sequential device like a socket may deliver the data in
+	// pieces and we must not block the GUI thread to wait for the rest
+	if (Device->isSequential())
 	{
+		qWarning() << "Dock manager state can only be restored from random access devices.";
 		return false;
 	}
 
-	// We hide the complete dock manager here. Restoring the state means
-	// that DockWidgets are removed from the DockArea internal stack layout
-	// which in turn  means, that each time a widget is removed the stack
-	// will show and raise the next available widget which in turn
-	// triggers show events for the dock widgets. To avoid this we hide the
-	// dock manager. Because there will be no processing of application
-	// events until this function is finished, the user will not see this
-	// hiding
-	bool IsHidden = this->isHidden();
-	if (!IsHidden)
+	return readStateData(Device, State);
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(const QByteArray &state, int version)
+{
+	DockingState ParsedState;
+	bool Parsed = parseState(state, ParsedState);
+	return d->restoreParsedState(Parsed ? &ParsedState : nullptr, version);
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(QIODevice* Device, int version)
+{
+	DockingState ParsedState;
+	bool Parsed = parseState(Device, ParsedState);
+	return d->restoreParsedState(Parsed ? &ParsedState : nullptr, version);
+}
+
+
+//============================================================================
+bool CDockManager::restoreState(const DockingState& State, int version)
+{
+	return d->restoreParsedState(&State, version);
+}
+
+
+//============================================================================
+QByteArray CDockManager::convertState(const QByteArray& State, eStateFormat Format)
+{
+	DockingState ParsedState;
+	if (!readStateData(State, ParsedState))
 	{
-		hide();
+		return QByteArray();
 	}
-	d->RestoringState = true;
-	Q_EMIT restoringState();
-	bool Result = d->restoreState(state, version);
-	d->RestoringState = false;
-	if (!IsHidden)
+
+	return writeStateData(ParsedState, Format);
+}
+
+
+//============================================================================
+bool CDockManager::isCompressionCodecAvailable(eCompressionCodec Codec)
+{
+	switch (Codec)
 	{
-		show();
+	case ZlibCodec:
+	case FastZlibCodec:
+		return true;
+
+	case ZstdCodec:
+#ifdef ADS_HAS_ZSTD
+		return true;
+#else
+		return false;
+#endif
+
+	case Lz4Codec:
+#ifdef ADS_HAS_LZ4
+		return true;
+#else
+		return false;
+#endif
 	}
-	Q_EMIT stateRestored();
-	return Result;
+
+	return false;
 }
 
 
@@ -1003,7 +1891,9 @@ QMap<QString, CDockWidget*> CDockManager::dockWidgetsMap() const
 //============================================================================
 void CDockManager::addPerspective(const QString& UniquePrespectiveName)
 {
-	d->Perspectives.insert(UniquePrespectiveName, saveState());
+	DockingState State;
+	d->captureState(State, 0);
+	d->Perspectives.insert(UniquePrespectiveName, State);
 	Q_EMIT perspectiveListChanged();
 }
 
@@ -1035,21 +1925,21 @@ void CDockManager::removePerspectives(const QStringList& Names)
 //============================================================================
 QStringList CDockManager::perspectiveNames() const
 {
-	return d->Perspectives.keys();
+	return d->Perspectives.names();
 }
 
 
 //============================================================================
 void CDockManager::openPerspective(const QString& PerspectiveName)
 {
-	const auto Iterator = d->Perspectives.find(PerspectiveName);
-	if (d->Perspectives.end() == Iterator)
+	DockingState State;
+	if (!d->Perspectives.state(PerspectiveName, State))
 	{
 		return;
 	}
 
 	Q_EMIT openingPerspective(PerspectiveName);
-	restoreState(Iterator.value());
+	restoreState(State);
 	Q_EMIT perspectiveOpened(PerspectiveName);
 }
 
@@ -1057,16 +1947,15 @@ void CDockManager::openPerspective(const QString& PerspectiveName)
 //============================================================================
 void CDockManager::savePerspectives(QSettings& Settings) const
 {
-	Settings.beginWriteArray("Perspectives", d->Perspectives.size());
-	int i = 0;
-	for (auto it = d->Perspectives.constBegin(); it != d->Perspectives.constEnd(); ++it)
+	// We remove the perspectives array of the old format, that stored the
+	// complete state of each perspective, to not keep outdated perspectives
+	Settings.remove("Perspectives");
+	QByteArray Data = d->Perspectives.toByteArray();
+	if (testConfigFlag(XmlCompressionEnabled))
 	{
-		Settings.setArrayIndex(i);
-		Settings.setValue("Name", it.key());
-		Settings.setValue("State", it.value());
-		++i;
+		Data = compressStateData(Data);
 	}
-	Settings.endArray();
+	Settings.setValue("PerspectiveStore", Data);
 }
 
 
@@ -1074,27 +1963,43 @@ void CDockManager::savePerspectives(QSettings& Settings) const
 void CDockManager::loadPerspectives(QSettings& Settings)
 {
 	d->Perspectives.clear();
-	int Size = Settings.beginReadArray("Perspectives");
-	if (!Size)
+	QByteArray StoreData = Settings.value("PerspectiveStore").toByteArray();
+	if (!StoreData.isEmpty())
 	{
-		Settings.endArray();
-		return;
+		if (!CDockPerspectiveStore::isStoreData(StoreData))
+		{
+			StoreData = uncompressStateData(StoreData);
+		}
+		d->Perspectives.fromByteArray(StoreData);
 	}
-
-	for (int i = 0; i < Size; ++i)
+	else
 	{
-		Settings.setArrayIndex(i);
-		QString Name = Settings.value("Name").toString();
-		QByteArray Data = Settings.value("State").toByteArray();
-		if (Name.isEmpty() || Data.isEmpty())
+		// Load perspectives stored in the old format, where each perspective
+		// is a complete state
+		int Size = Settings.beginReadArray("Perspectives");
+		if (!Size)
 		{
-			continue;
+			Settings.endArray();
+			return;
+		}
+
+		for (int i = 0; i < Size; ++i)
+		{
+			Settings.setArrayIndex(i);
+			QString Name = Settings.value("Name").toString();
+			QByteArray Data = Settings.value("State").toByteArray();
+			DockingState State;
+			if (Name.isEmpty() || !readStateData(Data, State))
+			{
+				continue;
+			}
+
+			d->Perspectives.insert(Name, State);
 		}
 
-		d->Perspectives.insert(Name, Data);
+		Settings.endArray();
 	}
 
-	Settings.endArray();
 	Q_EMIT perspectiveListChanged();
 	Q_EMIT perspectiveListLoaded();
 }
@@ -1113,6 +2018,7 @@ CDockAreaWidget* CDockManager::setCentralWidget(CDockWidget* widget)
 	if (!widget)
 	{
 		d->CentralWidget = nullptr;
+		d->StateGeneration = nextLayoutGeneration();
 		return nullptr;
 	}
 
@@ -1256,6 +2162,148 @@ bool CDockManager::testAutoHideConfigFlag(eAutoHideFlag Flag)
 }
 
 
+//===========================================================================
+void CDockManager::setConfigParam(eConfigParam Param, QVariant Value)
+{
+	StaticConfigParams[Param] = Value;
+}
+
+
+//===========================================================================
+QVariant CDockManager::configParam(eConfigParam Param, QVariant Default)
+{
+	return StaticConfigParams[Param].isValid() ? StaticConfigParams[Param] : Default;
+}
+
+
+//============================================================================
+CDockAreaWidget* CDockManager::createDockArea(CDockContainerWidget* DockContainer)
+{
+	while (!d->DockAreaPool.isEmpty())
+	{
+		CDockAreaWidget* DockArea = d->DockAreaPool.takeLast();
+		if (!DockArea)
+		{
+			continue;
+		}
+
+		DockArea->setParent(DockContainer);
+		return DockArea;
+	}
+
+	return new CDockAreaWidget(this, DockContainer);
+}
+
+
+//============================================================================
+bool CDockManager::recycleDockArea(CDockAreaWidget* DockArea)
+{
+	// Only empty dock areas that are not part of an auto hide container
+	// can be reused
+	if (!DockManagerPrivate::widgetPoolSize() || DockArea->dockWidgetsCount()
+	 || DockArea->isAutoHide())
+	{
+		return false;
+	}
+
+	auto DockContainer = DockArea->dockContainer();
+	if (DockContainer)
+	{
+		DockArea->disconnect(DockContainer);
+	}
+
+	DockArea->resetForReuse();
+	d->recycleWidget(DockArea);
+	return true;
+}
+
+
+//============================================================================
+CDockSplitter* CDockManager::takePooledSplitter(QWidget* Parent)
+{
+	while (!d->SplitterPool.isEmpty())
+	{
+		CDockSplitter* Splitter = d->SplitterPool.takeLast();
+		if (Splitter)
+		{
+			Splitter->setParent(Parent);
+			return Splitter;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+bool CDockManager::recycleSplitter(CDockSplitter* Splitter)
+{
+	if (!DockManagerPrivate::widgetPoolSize() || Splitter->count())
+	{
+		return false;
+	}
+
+	d->recycleWidget(Splitter);
+	return true;
+}
+
+//============================================================================
+CFloatingDragPreview* CDockManager::dragPreview()
+{
+	if (!d->DragPreview)
+	{
+		d->DragPreview = new CFloatingDragPreview(nullptr, this);
+	}
+	return d->DragPreview;
+}
+
+
+//============================================================================
+bool CDockManager::deferViewToggled(CDockWidget* DockWidget)
+{
+	if (!d->BatchingSignals)
+	{
+		return false;
+	}
+
+	d->BatchedViewToggles.insert(DockWidget);
+	return true;
+}
+
+
+//============================================================================
+bool CDockManager::deferTopLevelChanged(CDockWidget* DockWidget)
+{
+	if (!d->BatchingSignals)
+	{
+		return false;
+	}
+
+	d->BatchedTopLevelChanges.insert(DockWidget);
+	return true;
+}
+
+
+//============================================================================
+bool CDockManager::deferDockAreasChanged(CDockContainerWidget* DockContainer, bool Added)
+{
+	if (!d->BatchingSignals)
+	{
+		return false;
+	}
+
+	if (Added)
+	{
+		d->BatchedAddedDockAreas.insert(DockContainer);
+	}
+	else
+	{
+		d->BatchedRemovedDockAreas.insert(DockContainer);
+	}
+	return true;
+}
+
+
 //===========================================================================
 CIconProvider& CDockManager::iconProvider()
 {
@@ -1365,6 +2413,7 @@ void CDockManager::setSplitterSizes(CDockAreaWidget *ContainedArea, const QList<
     if (Splitter && Splitter->count() == sizes.count())
     {
         Splitter->setSizes(sizes);
+        ContainedArea->dockContainer()->markLayoutChanged();
     }
 }
 
@@ -35,9 +35,12 @@
 #include "DockWidget.h"
 #include "FloatingDockContainer.h"
 
+#include <QVariant>
+
 
 QT_FORWARD_DECLARE_CLASS(QSettings)
 QT_FORWARD_DECLARE_CLASS(QMenu)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
 
 namespace ads
 {
@@ -54,10 +57,28 @@ struct DockAreaWidgetPrivate;
 class CIconProvider;
 class CDockComponentsFactory;
 class CDockFocusController;
+class CDockSplitter;
+class CFloatingDragPreview;
+struct DockingState;
 class CAutoHideSideBar;
 class CAutoHideTab;
 struct AutoHideTabPrivate;
 
+/**
+ * Summary of the changes of a restoreState() call, if the
+ * BatchedRestoreSignals flag is set. Each object is contained only once,
+ * even if it changed multiple times during the restore.
+ * \see CDockManager::batchedStateChanges()
+ */
+struct ADS_EXPORT DockRestoreChanges
+{
+	QList<CDockWidget*> OpenedDockWidgets; ///< dock widgets that emitted viewToggled(true) before
+	QList<CDockWidget*> ClosedDockWidgets; ///< dock widgets that emitted viewToggled(false) before
+	QList<CDockWidget*> TopLevelChangedDockWidgets; ///< dock widgets that emitted topLevelChanged() before
+	QList<CDockContainerWidget*> ContainersWithAddedDockAreas; ///< containers that emitted dockAreasAdded() before
+	QList<CDockContainerWidget*> ContainersWithRemovedDockAreas; ///< containers that emitted dockAreasRemoved() before
+};
+
 /**
  * The central dock manager that maintains the complete docking system.
  * With the configuration flags you can globally control the functionality
@@ -87,10 +108,12 @@ private:
 	friend class CFloatingDragPreview;
 	friend struct FloatingDragPreviewPrivate;
 	friend class CDockAreaTitleBar;
+	friend class CDockAreaWidget;
 	friend class CAutoHideDockContainer;
 	friend CAutoHideSideBar;
 	friend CAutoHideTab;
 	friend AutoHideTabPrivate;
+	friend class CDockWidget;
 
 public Q_SLOTS:
 	/**
@@ -165,6 +188,64 @@ protected:
      */
     void restoreHiddenFloatingWidgets();
 
+	/**
+	 * Returns an empty dock area for the given container. If the widget pool
+	 * is enabled via the WidgetPoolSize config parameter, a previously
+	 * recycled dock area is reused, otherwise a new dock area is created.
+	 * A reused dock area does not emit the dockAreaCreated() signal again.
+	 */
+	CDockAreaWidget* createDockArea(CDockContainerWidget* DockContainer);
+
+	/**
+	 * Moves the given empty dock area into the widget pool, if the pool is
+	 * enabled. The dock area becomes available for reuse in the next event
+	 * loop cycle, so the caller can still safely access it, like a widget
+	 * that has been scheduled for deletion.
+	 * Returns false, if the dock area has not been recycled. In this case the
+	 * caller is still responsible for deleting the dock area.
+	 */
+	bool recycleDockArea(CDockAreaWidget* DockArea);
+
+	/**
+	 * Returns a splitter from the widget pool or a nullptr, if the pool
+	 * contains no splitter
+	 */
+	CDockSplitter* takePooledSplitter(QWidget* Parent);
+
+	/**
+	 * Moves the given empty splitter into the widget pool - see
+	 * recycleDockArea()
+	 */
+	bool recycleSplitter(CDockSplitter* Splitter);
+
+	/**
+	 * Returns the drag preview window that is used for all non opaque drag
+	 * operations of this dock manager. The window is created on first use
+	 * and is kept alive and reused for all following drag operations.
+	 */
+	CFloatingDragPreview* dragPreview();
+
+	/**
+	 * Returns true, if the viewToggled() signal of the given dock widget
+	 * is batched into the batchedStateChanges() signal of a running
+	 * restore. In this case, the caller must not emit the signal.
+	 */
+	bool deferViewToggled(CDockWidget* DockWidget);
+
+	/**
+	 * Returns true, if the topLevelChanged() signal of the given dock widget
+	 * is batched into the batchedStateChanges() signal - see
+	 * deferViewToggled()
+	 */
+	bool deferTopLevelChanged(CDockWidget* DockWidget);
+
+	/**
+	 * Returns true, if the dockAreasAdded() or dockAreasRemoved() signal of
+	 * the given container is batched into the batchedStateChanges() signal -
+	 * see deferViewToggled()
+	 */
+	bool deferDockAreasChanged(CDockContainerWidget* DockContainer, bool Added);
+
 public:
 	using Super = CDockContainerWidget;
 
@@ -174,6 +255,15 @@ public:
 		MenuAlphabeticallySorted
 	};
 
+	/**
+	 * Format of the state data created by saveState()
+	 */
+	enum eStateFormat
+	{
+		XmlStateFormat,   ///< human readable XML - this is the default format
+		BinaryStateFormat ///< compact binary format that is much faster to save and restore
+	};
+
 	/**
 	 * These global configuration flags configure some global dock manager
 	 * settings.
@@ -215,6 +305,9 @@ public:
 		MiddleMouseButtonClosesTab = 0x2000000, //! If the flag is set, the user can use the mouse middle button to close the tab under the mouse
 		DisableTabTextEliding =      0x4000000, //! Set this flag to disable eliding of tab texts in dock area tabs
 		ShowTabTextOnlyForActiveTab =0x8000000, //! Set this flag to show label texts in dock area tabs only for active tabs
+		BatchedRestoreSignals = 0x10000000, //! If set, restoreState() emits one batchedStateChanges() signal instead of the viewToggled(), topLevelChanged(), dockAreasAdded() and dockAreasRemoved() signals of all restored objects
+		CoalesceDragMove = 0x20000000, //! If set, the drop overlays and the dragged floating widget are updated at most once per display frame while dragging, always for the latest cursor position
+		FloatingWidgetDragShowsSnapshot = 0x40000000, //! If set, a dragged floating widget shows a snapshot pixmap of its content instead of the live content until it is dropped
 
         DefaultDockAreaButtons = DockAreaHasCloseButton
 							   | DockAreaHasUndockButton
@@ -263,6 +356,32 @@ public:
     Q_DECLARE_FLAGS(AutoHideFlags, eAutoHideFlag)
 
 
+	/**
+	 * Global configuration parameters that need a value instead of a simple
+	 * on / off flag.
+	 * Set the parameters, before you create the dock manager instance.
+	 */
+	enum eConfigParam
+	{
+		WidgetPoolSize, ///< int - max. number of empty dock areas and splitters kept for reuse, 0 (default) disables pooling
+		CompressionCodec, ///< eCompressionCodec - codec for compressed states if XmlCompressionEnabled is set, default is ZlibCodec
+		ConfigParamCount ///< just a delimiter to know number of config params
+	};
+
+	/**
+	 * Codecs for the compression of saved states and perspectives.
+	 * The codec is stored in the header of the compressed data, so
+	 * restoreState() detects the codec automatically.
+	 */
+	enum eCompressionCodec
+	{
+		ZlibCodec,     ///< zlib with the best compression - the format of older versions of this library
+		FastZlibCodec, ///< zlib with the fastest compression level
+		ZstdCodec,     ///< zstd - requires a library built with ADS_WITH_ZSTD
+		Lz4Codec       ///< LZ4 - requires a library built with ADS_WITH_LZ4
+	};
+
+
 	/**
 	 * Default Constructor.
 	 * If the given parent is a QMainWindow, the dock manager sets itself as the
@@ -323,6 +442,17 @@ public:
 	 */
 	static bool testAutoHideConfigFlag(eAutoHideFlag Flag);
 
+	/**
+	 * Sets the value for the given config parameter
+	 */
+	static void setConfigParam(eConfigParam Param, QVariant Value);
+
+	/**
+	 * Returns the value for the given config parameter or the given Default
+	 * value, if the parameter is not set
+	 */
+	static QVariant configParam(eConfigParam Param, QVariant Default);
+
 	/**
 	 * Returns the global icon provider.
 	 * The icon provider enables the use of custom icons in case using
@@ -437,11 +567,47 @@ public:
 	 * The XmlMode XmlAutoFormattingDisabled is better if you would like to have
 	 * a more compact XML output - i.e. for storage in ini files.
 	 * The version number is stored as part of the data.
+	 * The Format defines if the state is written as XML or in the compact
+	 * binary format. If XmlCompressionEnabled is set, the data is compressed
+	 * in both formats.
 	 * To restore the saved state, pass the return value and version number
-	 * to restoreState().
+	 * to restoreState(). restoreState() detects the format automatically.
 	 * \see restoreState()
 	 */
-	QByteArray saveState(int version = 0) const;
+	QByteArray saveState(int version = 0, eStateFormat Format = XmlStateFormat) const;
+
+	/**
+	 * Saves the current state directly into the given device, e.g. a file
+	 * or a socket. The state is written while it is serialized and, if
+	 * XmlCompressionEnabled is set, compressed in chunks. So the complete
+	 * state is never held in memory. Returns false, if writing failed.
+	 * Compressed data written by this function can be restored by both
+	 * restoreState() overloads, but not by older versions of this library.
+	 */
+	bool saveState(QIODevice* Device, int version = 0, eStateFormat Format = XmlStateFormat) const;
+
+	/**
+	 * Creates the same data like saveState() but only captures the state of
+	 * the dock containers, that changed since the last call of this
+	 * function. For all unchanged containers, the state captured by the
+	 * last call is reused. Use this function instead of saveState() if
+	 * you save the state frequently - e.g. for an autosave timer.
+	 * \see stateGeneration()
+	 */
+	QByteArray saveStateIncremental(int version = 0, eStateFormat Format = XmlStateFormat) const;
+
+	/**
+	 * Returns the generation of the layout state of this dock manager.
+	 * The generation changes whenever the state saved by saveState()
+	 * changes - i.e. if dock widgets are moved, opened or closed, if dock
+	 * areas are split, if splitter sizes change or if dock widgets are
+	 * pinned to or removed from an auto hide side bar. Compare the returned
+	 * value with the value of the last save to detect, if the layout needs
+	 * to be saved again.
+	 * Changes of the window geometry of floating widgets do not change the
+	 * generation.
+	 */
+	quint64 stateGeneration() const;
 
 	/**
 	 * Restores the state of this dockmanagers dockwidgets.
@@ -453,6 +619,61 @@ public:
 	 */
 	bool restoreState(const QByteArray &state, int version = 0);
 
+	/**
+	 * Restores the state from the given random access device, e.g. from a
+	 * file. The state is parsed while it is read from the device. Only data
+	 * that has been compressed by saveState(QIODevice*, int, eStateFormat) is
+	 * uncompressed chunk by chunk - data compressed into a QByteArray by
+	 * saveState(int, eStateFormat) is uncompressed as a whole.
+	 * Sequential devices like sockets are not supported, because the
+	 * function would need to block until all data arrived. The function
+	 * returns false for sequential devices. Receive the data into a
+	 * QByteArray or a temporary file first.
+	 */
+	bool restoreState(QIODevice* Device, int version = 0);
+
+	/**
+	 * Parses the given saved state into the plain data layout description
+	 * State. The function decompresses the data, decodes the XML or binary
+	 * format and checks the structure of the layout. It does not access any
+	 * widget, so it is thread safe and can be called from a worker thread
+	 * to overlap the decoding of a large state with other startup work.
+	 * Pass the parsed state to restoreState(const DockingState&, int) in the
+	 * GUI thread to apply it. Returns false, if the data is not a valid state.
+	 */
+	static bool parseState(const QByteArray &state, DockingState& State);
+
+	/**
+	 * Parses the saved state from the given random access device - see
+	 * parseState(const QByteArray&, DockingState&) and
+	 * restoreState(QIODevice*, int)
+	 */
+	static bool parseState(QIODevice* Device, DockingState& State);
+
+	/**
+	 * Restores the given state created by parseState(). This function works
+	 * like restoreState(const QByteArray&, int) without the parsing step and
+	 * needs to be called from the GUI thread. The layout trees of the state
+	 * are not checked again, so a state that has not been created by
+	 * parseState() needs to be valid - see DockingState::isValid().
+	 */
+	bool restoreState(const DockingState& State, int version = 0);
+
+	/**
+	 * Converts the given saved state into the given Format. The source
+	 * format is detected automatically. The compression of the returned data
+	 * depends on the XmlCompressionEnabled flag like in saveState().
+	 * Returns an empty byte array, if State is not a valid saved state.
+	 */
+	static QByteArray convertState(const QByteArray& State, eStateFormat Format);
+
+	/**
+	 * Returns true, if the given compression codec has been enabled when
+	 * building the library. If the codec selected via the CompressionCodec
+	 * config parameter is not available, FastZlibCodec is used instead.
+	 */
+	static bool isCompressionCodecAvailable(eCompressionCodec Codec);
+
 	/**
 	 * Saves the current perspective to the internal list of perspectives.
 	 * A perspective is the current state of the dock manager assigned
@@ -480,11 +701,15 @@ public:
 
 	/**
 	 * Saves the perspectives to the given settings file.
+	 * Dock areas, splitter subtrees and containers that are shared by
+	 * several perspectives are stored only once.
 	 */
 	void savePerspectives(QSettings& Settings) const;
 
 	/**
-	 * Loads the perspectives from the given settings file
+	 * Loads the perspectives from the given settings file.
+	 * Perspectives saved by older versions of this library, that stored each
+	 * perspective as a complete state, are still loaded.
 	 */
 	void loadPerspectives(QSettings& Settings);
 
@@ -743,6 +968,15 @@ Q_SIGNALS:
      */
     void stateRestored();
 
+    /**
+     * This signal is emitted at the end of restoreState() or
+     * openPerspective() just before stateRestored(), if the
+     * BatchedRestoreSignals flag is set. The signal replaces the
+     * viewToggled(), topLevelChanged(), dockAreasAdded() and
+     * dockAreasRemoved() signals of all objects changed by the restore.
+     */
+    void batchedStateChanges(const ads::DockRestoreChanges& Changes);
+
     /**
      * This signal is emitted, if the dock manager starts opening a
      * perspective.
@@ -803,5 +1037,6 @@ Q_SIGNALS:
 } // namespace ads
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(ads::CDockManager::ConfigFlags)
+Q_DECLARE_METATYPE(ads::DockRestoreChanges)
 //-----------------------------------------------------------------------------
 #endif // DockManagerH
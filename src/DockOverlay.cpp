@@ -35,6 +35,7 @@
 #include <QDebug>
 #include <QMap>
 #include <QWindow>
+#include <QPixmapCache>
 
 #include "DockAreaWidget.h"
 #include "DockAreaTitleBar.h"
@@ -42,6 +43,7 @@
 #include "AutoHideSideBar.h"
 #include "DockManager.h"
 #include "DockAreaTabBar.h"
+#include "DockDragSnapshot.h"
 
 #include <iostream>
 
@@ -65,12 +67,39 @@ struct DockOverlayPrivate
 	CDockOverlay::eMode Mode = CDockOverlay::ModeDockAreaOverlay;
 	QRect DropAreaRect;
 	int TabIndex = InvalidTabIndex;
+	QSharedPointer<const CDockDragSnapshot> DragSnapshot;
+	QPoint DragCursorPos;
+	const DockDragContainerTarget* ContainerTarget = nullptr;
+	const DockDragAreaTarget* DockAreaTarget = nullptr;
 
 	/**
 	 * Private data constructor
 	 */
 	DockOverlayPrivate(CDockOverlay* _public) : _this(_public) {}
 
+	/**
+	 * Looks up the snapshot data of the current target widget
+	 */
+	void updateSnapshotTarget();
+
+	/**
+	 * Resolves the drop area under the cursor from the drag snapshot data
+	 */
+	DockWidgetArea snapshotDropArea();
+
+	/**
+	 * Returns the rectangle of the drop preview for the given drop area or
+	 * an invalid rectangle, if no drop preview should be painted
+	 */
+	QRect dropPreviewRect(DockWidgetArea Area);
+
+	/**
+	 * Updates the drop preview rectangle for the given drop area. Only the
+	 * union of the old and the new rectangle is repainted and nothing is
+	 * repainted, if the rectangle did not change
+	 */
+	void updateDropPreview(DockWidgetArea Area, bool Immediate);
+
 	/**
 	 * Returns the overlay width / height depending on the visibility
 	 * of the sidebar
@@ -189,7 +218,7 @@ struct DockOverlayCrossPrivate
 			}
         }
 
-		l->setPixmap(createHighDpiDropIndicatorPixmap(size, DockWidgetArea, Mode));
+		l->setPixmap(dropIndicatorPixmap(size, DockWidgetArea, Mode));
 		l->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint);
 		l->setAttribute(Qt::WA_TranslucentBackground);
 		l->setProperty("dockWidgetArea", DockWidgetArea);
@@ -204,7 +233,48 @@ struct DockOverlayCrossPrivate
 		const QSizeF size(metric, metric);
 
 		int Area = l->property("dockWidgetArea").toInt();
-		l->setPixmap(createHighDpiDropIndicatorPixmap(size, (DockWidgetArea)Area, Mode));
+		l->setPixmap(dropIndicatorPixmap(size, (DockWidgetArea)Area, Mode));
+	}
+
+	//============================================================================
+	double devicePixelRatio() const
+	{
+#if QT_VERSION >= 0x050600
+		return _this->window()->devicePixelRatioF();
+#else
+		return _this->window()->devicePixelRatio();
+#endif
+	}
+
+	//============================================================================
+	/**
+	 * Returns the drop indicator pixmap from the global QPixmapCache. The
+	 * pixmap is only rendered, if it is not cached yet. Because the key
+	 * contains all rendering parameters, the pixmaps are shared between
+	 * the container overlay and the dock area overlay and switching the
+	 * overlay target while dragging only swaps cached pixmaps.
+	 */
+	QPixmap dropIndicatorPixmap(const QSizeF& size, DockWidgetArea DockWidgetArea,
+		CDockOverlay::eMode Mode)
+	{
+		QString Key = QString("ads_drop_indicator_%1x%2_%3_%4_%5")
+			.arg(size.width()).arg(size.height()).arg(int(DockWidgetArea))
+			.arg(int(Mode)).arg(devicePixelRatio());
+		for (int i = CDockOverlayCross::FrameColor; i <= CDockOverlayCross::ShadowColor; ++i)
+		{
+			Key += QLatin1Char('_');
+			Key += QString::number(iconColor(static_cast<CDockOverlayCross::eIconColor>(i)).rgba(), 16);
+		}
+
+		QPixmap Pixmap;
+		if (QPixmapCache::find(Key, &Pixmap))
+		{
+			return Pixmap;
+		}
+
+		Pixmap = createHighDpiDropIndicatorPixmap(size, DockWidgetArea, Mode);
+		QPixmapCache::insert(Key, Pixmap);
+		return Pixmap;
 	}
 
 	//============================================================================
@@ -219,11 +289,7 @@ struct DockOverlayCrossPrivate
 			overlayColor.setAlpha(64);
 		}
 
-#if QT_VERSION >= 0x050600
-		double DevicePixelRatio = _this->window()->devicePixelRatioF();
-#else
-        double DevicePixelRatio = _this->window()->devicePixelRatio();
-#endif
+		double DevicePixelRatio = devicePixelRatio();
 		QSizeF PixmapSize = size * DevicePixelRatio;
 		QPixmap pm(PixmapSize.toSize());
 		pm.fill(QColor(0, 0, 0, 0));
@@ -396,6 +462,150 @@ int DockOverlayPrivate::sideBarMouseZone(SideBarLocation sideBarLocation)
 }
 
 
+//============================================================================
+QRect DockOverlayPrivate::dropPreviewRect(DockWidgetArea Area)
+{
+	if (!DropPreviewEnabled)
+	{
+		return QRect();
+	}
+
+	QRect r = _this->rect();
+	double Factor = (CDockOverlay::ModeContainerOverlay == Mode) ?
+		3 : 2;
+
+	switch (Area)
+	{
+	case TopDockWidgetArea: r.setHeight(r.height() / Factor); break;
+	case RightDockWidgetArea: r.setX(r.width() * (1 - 1 / Factor)); break;
+	case BottomDockWidgetArea: r.setY(r.height() * (1 - 1 / Factor)); break;
+	case LeftDockWidgetArea: r.setWidth(r.width() / Factor); break;
+	case CenterDockWidgetArea: r = _this->rect();break;
+	case LeftAutoHideArea: r.setWidth(sideBarOverlaySize(SideBarLeft)); break;
+	case RightAutoHideArea: r.setX(r.width() - sideBarOverlaySize(SideBarRight)); break;
+	case TopAutoHideArea: r.setHeight(sideBarOverlaySize(SideBarTop)); break;
+	case BottomAutoHideArea: r.setY(r.height() - sideBarOverlaySize(SideBarBottom)); break;
+	default: return QRect();
+	}
+
+	return r;
+}
+
+
+//============================================================================
+void DockOverlayPrivate::updateDropPreview(DockWidgetArea Area, bool Immediate)
+{
+	LastLocation = Area;
+	QRect Rect = dropPreviewRect(Area);
+	if (Rect == DropAreaRect)
+	{
+		return;
+	}
+
+	QRect DirtyRect = DropAreaRect.united(Rect);
+	DropAreaRect = Rect;
+	if (Immediate)
+	{
+		_this->repaint(DirtyRect);
+	}
+	else
+	{
+		_this->update(DirtyRect);
+	}
+}
+
+
+//============================================================================
+void DockOverlayPrivate::updateSnapshotTarget()
+{
+	ContainerTarget = nullptr;
+	DockAreaTarget = nullptr;
+	if (!DragSnapshot || !TargetWidget)
+	{
+		return;
+	}
+
+	if (CDockOverlay::ModeContainerOverlay == Mode)
+	{
+		ContainerTarget = DragSnapshot->container(TargetWidget);
+	}
+	else
+	{
+		DockAreaTarget = DragSnapshot->dockArea(TargetWidget);
+	}
+}
+
+
+//============================================================================
+DockWidgetArea DockOverlayPrivate::snapshotDropArea()
+{
+	const QPoint CursorPos = DragCursorPos;
+	DockWidgetArea Result = Cross->locationAt(CursorPos);
+	if (Result != InvalidDockWidgetArea)
+	{
+		return Result;
+	}
+
+	if (ContainerTarget)
+	{
+		if (!CDockManager::autoHideConfigFlags().testFlag(CDockManager::AutoHideFeatureEnabled))
+		{
+			return Result;
+		}
+
+		auto MouseZone = [this](SideBarLocation Location)
+		{
+			int Size = ContainerTarget->SideBarSizes[Location];
+			return Size ? Size : AutoHideAreaMouseZone;
+		};
+
+		const QRect& Rect = ContainerTarget->Rect;
+		const QPoint pos = CursorPos - Rect.topLeft();
+		if ((pos.x() < MouseZone(SideBarLeft))
+		  && AllowedAreas.testFlag(LeftAutoHideArea))
+		{
+			Result = LeftAutoHideArea;
+		}
+		else if (pos.x() > (Rect.width() - MouseZone(SideBarRight))
+			  && AllowedAreas.testFlag(RightAutoHideArea))
+		{
+			Result = RightAutoHideArea;
+		}
+		else if (pos.y() < MouseZone(SideBarTop)
+			&& AllowedAreas.testFlag(TopAutoHideArea))
+		{
+			Result = TopAutoHideArea;
+		}
+		else if (pos.y() > (Rect.height() - MouseZone(SideBarBottom))
+			&& AllowedAreas.testFlag(BottomAutoHideArea))
+		{
+			Result = BottomAutoHideArea;
+		}
+
+		auto SideBarLocation = ads::internal::toSideBarLocation(Result);
+		if (SideBarLocation != SideBarNone)
+		{
+			const auto& SideBarTabs = ContainerTarget->SideBarTabs[SideBarLocation];
+			if (SideBarTabs.Visible)
+			{
+				TabIndex = SideBarTabs.tabInsertIndexAt(CursorPos);
+			}
+		}
+		return Result;
+	}
+
+	if (DockAreaTarget->AllowedAreas.testFlag(CenterDockWidgetArea)
+	 && DockAreaTarget->TitleBarVisible
+	 && DockAreaTarget->TitleBarRect.contains(CursorPos))
+	{
+		TabIndex = DockAreaTarget->Tabs.tabInsertIndexAt(CursorPos);
+		return CenterDockWidgetArea;
+	}
+
+	return Result;
+}
+
+
 //============================================================================
 CDockOverlay::CDockOverlay(QWidget* parent, eMode Mode) :
 	QFrame(parent),
@@ -465,6 +675,11 @@ DockWidgetArea CDockOverlay::dropAreaUnderCursor() const
 		return InvalidDockWidgetArea;
 	}
 
+	if (d->ContainerTarget || d->DockAreaTarget)
+	{
+		return d->snapshotDropArea();
+	}
+
 	DockWidgetArea Result = d->Cross->cursorLocation();
 	if (Result != InvalidDockWidgetArea)
 	{
@@ -556,16 +771,14 @@ DockWidgetArea CDockOverlay::showOverlay(QWidget* target)
 	{
 		// Hint: We could update geometry of overlay here.
 		DockWidgetArea da = dropAreaUnderCursor();
-		if (da != d->LastLocation)
-		{
-			repaint();
-			d->LastLocation = da;
-		}
+		d->updateDropPreview(da, true);
 		return da;
 	}
 
 	d->TargetWidget = target;
 	d->LastLocation = InvalidDockWidgetArea;
+	d->DropAreaRect = QRect();
+	d->updateSnapshotTarget();
 
 	// Move it over the target.
 	hide();
@@ -575,7 +788,9 @@ DockWidgetArea CDockOverlay::showOverlay(QWidget* target)
 	show();
 	d->Cross->updatePosition();
 	d->Cross->updateOverlayIcons();
-	return dropAreaUnderCursor();
+	DockWidgetArea da = dropAreaUnderCursor();
+	d->updateDropPreview(da, false);
+	return da;
 }
 
 
@@ -586,14 +801,33 @@ void CDockOverlay::hideOverlay()
 	d->TargetWidget.clear();
 	d->LastLocation = InvalidDockWidgetArea;
 	d->DropAreaRect = QRect();
+	d->updateSnapshotTarget();
+}
+
+
+//============================================================================
+void CDockOverlay::setDragSnapshot(const QSharedPointer<const CDockDragSnapshot>& Snapshot,
+	const QPoint& GlobalPos)
+{
+	d->DragCursorPos = GlobalPos;
+	if (d->DragSnapshot != Snapshot)
+	{
+		d->DragSnapshot = Snapshot;
+		d->updateSnapshotTarget();
+	}
 }
 
 
 //============================================================================
 void CDockOverlay::enableDropPreview(bool Enable)
 {
+	if (d->DropPreviewEnabled == Enable)
+	{
+		return;
+	}
+
 	d->DropPreviewEnabled = Enable;
-	update();
+	d->updateDropPreview(d->LastLocation, false);
 }
 
 
@@ -609,32 +843,14 @@ void CDockOverlay::paintEvent(QPaintEvent* event)
 {
 	Q_UNUSED(event);
 
-	// Draw rect based on location
-	if (!d->DropPreviewEnabled)
+	// The drop preview rect is calculated in showOverlay() and
+	// enableDropPreview() to repaint only the changed region
+	const QRect r = d->DropAreaRect;
+	if (!d->DropPreviewEnabled || !r.isValid())
 	{
-		d->DropAreaRect = QRect();
 		return;
 	}
 
-	QRect r = rect();
-	const DockWidgetArea da = dropAreaUnderCursor();
-	double Factor = (CDockOverlay::ModeContainerOverlay == d->Mode) ?
-		3 : 2;
-
-	switch (da)
-	{
-    case TopDockWidgetArea: r.setHeight(r.height() / Factor); break;
-	case RightDockWidgetArea: r.setX(r.width() * (1 - 1 / Factor)); break;
-	case BottomDockWidgetArea: r.setY(r.height() * (1 - 1 / Factor)); break;
-	case LeftDockWidgetArea: r.setWidth(r.width() / Factor); break;
-	case CenterDockWidgetArea: r = rect();break;
-	case LeftAutoHideArea: r.setWidth(d->sideBarOverlaySize(SideBarLeft)); break;
-	case RightAutoHideArea: r.setX(r.width() - d->sideBarOverlaySize(SideBarRight)); break;
-	case TopAutoHideArea: r.setHeight(d->sideBarOverlaySize(SideBarTop)); break;
-	case BottomAutoHideArea: r.setY(r.height() - d->sideBarOverlaySize(SideBarBottom)); break;
-	default: return;
-	}
-
 	QPainter painter(this);
     QColor Color = palette().color(QPalette::Active, QPalette::Highlight);
     QPen Pen = painter.pen();
@@ -647,7 +863,6 @@ void CDockOverlay::paintEvent(QPaintEvent* event)
     Color.setAlpha(64);
     painter.setBrush(Color);
 	painter.drawRect(r.adjusted(0, 0, -1, -1));
-	d->DropAreaRect = r;
 }
 
 
@@ -879,7 +1094,14 @@ void CDockOverlayCross::setAreaWidgets(const QHash<DockWidgetArea, QWidget*>& wi
 //============================================================================
 DockWidgetArea CDockOverlayCross::cursorLocation() const
 {
-	const QPoint pos = mapFromGlobal(QCursor::pos());
+	return locationAt(QCursor::pos());
+}
+
+
+//============================================================================
+DockWidgetArea CDockOverlayCross::locationAt(const QPoint& GlobalPos) const
+{
+	const QPoint pos = mapFromGlobal(GlobalPos);
 	QHashIterator<DockWidgetArea, QWidget*> i(d->DropIndicatorWidgets);
 	while (i.hasNext())
 	{
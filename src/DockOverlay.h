@@ -23,6 +23,7 @@
 //                                   INCLUDES
 //============================================================================
 #include <QPointer>
+#include <QSharedPointer>
 #include <QHash>
 #include <QRect>
 #include <QFrame>
@@ -35,6 +36,7 @@ namespace ads
 {
 struct DockOverlayPrivate;
 class CDockOverlayCross;
+class CDockDragSnapshot;
 
 /*!
  * DockOverlay paints a translucent rectangle over another widget. The geometry
@@ -115,6 +117,16 @@ public:
 	 */
 	void hideOverlay();
 
+	/**
+	 * Sets the drop target snapshot of the running drag operation and the
+	 * global cursor position of the current mouse move.
+	 * As long as a snapshot is set, dropAreaUnderCursor() resolves the drop
+	 * area from the snapshot data for the given cursor position instead of
+	 * querying the target widgets. Pass a null snapshot if dragging ends.
+	 */
+	void setDragSnapshot(const QSharedPointer<const CDockDragSnapshot>& Snapshot,
+		const QPoint& GlobalPos = QPoint());
+
 	/**
 	 * Enables / disables the semi transparent overlay rectangle that represents
 	 * the future area of the dropped widget
@@ -238,6 +250,12 @@ public:
 	 */
 	DockWidgetArea cursorLocation() const;
 
+	/**
+	 * Returns the dock widget area of the drop indicator widget at the given
+	 * global position
+	 */
+	DockWidgetArea locationAt(const QPoint& GlobalPos) const;
+
 	/**
 	 * Sets up the overlay cross for the given overlay mode
 	 */
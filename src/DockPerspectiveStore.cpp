@@ -0,0 +1,665 @@
+//============================================================================
+/// \file   DockPerspectiveStore.cpp
+/// \date   16.10.2026
+/// \brief  Implementation of CDockPerspectiveStore
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockPerspectiveStore.h"
+
+#include <QHash>
+#include <QMap>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QIODevice>
+
+#include <algorithm>
+
+namespace ads
+{
+/**
+ * The serialized store starts with this magic header followed by the
+ * store format version
+ */
+static const char StoreMagic[] = {'A', 'D', 'S', 'P'};
+static const int StoreMagicSize = sizeof(StoreMagic);
+static const quint32 StoreVersion = 1;
+static const int StoreStreamVersion = QDataStream::Qt_5_6;
+
+/**
+ * The different kinds of blobs. Each blob starts with its type and the
+ * hashes of the blobs it references followed by the type specific data.
+ */
+enum eBlobType
+{
+	AreaBlob = 1,    ///< dock area node - no child blobs
+	SplitterBlob,    ///< splitter node - child blobs are the child nodes
+	ContainerBlob,   ///< dock container - child blob is the root node
+	StateBlob        ///< complete state - child blobs are the containers
+};
+
+
+/**
+ * A blob in the store with the hashes of the blobs it references
+ */
+struct StoreBlob
+{
+	QByteArray Data;
+	QVector<QByteArray> Children;
+	int RefCount = 0;
+};
+
+
+/**
+ * Creates the data of a blob from the given type, child blob hashes and
+ * the type specific Payload
+ */
+static QByteArray blobData(eBlobType Type, const QVector<QByteArray>& Children,
+	const QByteArray& Payload)
+{
+	QByteArray Data;
+	QDataStream s(&Data, QIODevice::WriteOnly);
+	s.setVersion(StoreStreamVersion);
+	s << quint8(Type) << qint32(Children.count());
+	for (const auto& Child : Children)
+	{
+		s << Child;
+	}
+	s.writeRawData(Payload.constData(), Payload.size());
+	return Data;
+}
+
+
+/**
+ * Reads the type and the child hashes of a blob. After this function
+ * the stream is positioned at the type specific payload.
+ */
+static bool readBlobHeader(QDataStream& s, quint8& Type, QVector<QByteArray>& Children)
+{
+	int ChildCount;
+	s >> Type;
+	if (!internal::readBinaryCount(s, ChildCount))
+	{
+		return false;
+	}
+
+	Children.resize(ChildCount);
+	for (auto& Child : Children)
+	{
+		s >> Child;
+	}
+
+	return s.status() == QDataStream::Ok;
+}
+
+
+/**
+ * Private data class of CDockPerspectiveStore class (pimpl)
+ */
+struct DockPerspectiveStorePrivate
+{
+	QHash<QByteArray, StoreBlob> Blobs;
+	QMap<QString, QByteArray> Perspectives; ///< maps names to state blob hashes
+
+	/**
+	 * Adds a blob with the given data and returns its hash. If the blob
+	 * already exists, only its reference count is incremented. The caller
+	 * passes ownership of one reference of each child blob to this function.
+	 */
+	QByteArray addBlob(const QByteArray& Data, const QVector<QByteArray>& Children);
+
+	/**
+	 * Releases one reference to the given blob. If the blob is not referenced
+	 * anymore, it is removed together with the references to its children.
+	 */
+	void releaseBlob(const QByteArray& Hash);
+
+	/**
+	 * Adds the node with the given index and all its children and returns
+	 * the hash of the node blob
+	 */
+	QByteArray addNode(const QVector<DockLayoutNode>& Nodes, int& Index);
+
+	/**
+	 * Adds the given container and returns the hash of the container blob
+	 */
+	QByteArray addContainer(const DockContainerState& Container);
+
+	/**
+	 * Adds the given state and returns the hash of the state blob
+	 */
+	QByteArray addState(const DockingState& State);
+
+	/**
+	 * Expands the node with the given hash and all its child nodes in
+	 * pre-order into Nodes
+	 */
+	bool expandNode(const QByteArray& Hash, QVector<DockLayoutNode>& Nodes) const;
+
+	/**
+	 * Expands the container blob with the given hash
+	 */
+	bool expandContainer(const QByteArray& Hash, DockContainerState& Container) const;
+
+	/**
+	 * Expands the state blob with the given hash
+	 */
+	bool expandState(const QByteArray& Hash, DockingState& State) const;
+};
+// struct DockPerspectiveStorePrivate
+
+
+//============================================================================
+QByteArray DockPerspectiveStorePrivate::addBlob(const QByteArray& Data,
+	const QVector<QByteArray>& Children)
+{
+	auto Hash = QCryptographicHash::hash(Data, QCryptographicHash::Sha1);
+	auto it = Blobs.find(Hash);
+	if (it != Blobs.end())
+	{
+		// The existing blob already references its children
+		for (const auto& Child : Children)
+		{
+			releaseBlob(Child);
+		}
+		it->RefCount++;
+		return Hash;
+	}
+
+	StoreBlob Blob;
+	Blob.Data = Data;
+	Blob.Children = Children;
+	Blob.RefCount = 1;
+	Blobs.insert(Hash, Blob);
+	return Hash;
+}
+
+
+//============================================================================
+void DockPerspectiveStorePrivate::releaseBlob(const QByteArray& Hash)
+{
+	auto it = Blobs.find(Hash);
+	if (it == Blobs.end() || --it->RefCount > 0)
+	{
+		return;
+	}
+
+	auto Children = it->Children;
+	Blobs.erase(it);
+	for (const auto& Child : Children)
+	{
+		releaseBlob(Child);
+	}
+}
+
+
+//============================================================================
+QByteArray DockPerspectiveStorePrivate::addNode(const QVector<DockLayoutNode>& Nodes,
+	int& Index)
+{
+	const auto& Node = Nodes[Index++];
+	QByteArray Payload;
+	QDataStream s(&Payload, QIODevice::WriteOnly);
+	s.setVersion(StoreStreamVersion);
+	if (Node.Type == DockLayoutNode::SplitterNode)
+	{
+		QVector<QByteArray> Children;
+		for (int i = 0; i < Node.ChildCount; ++i)
+		{
+			Children.append(addNode(Nodes, Index));
+		}
+
+		s << quint8(Node.Orientation) << qint32(Node.Sizes.count());
+		for (auto Size : Node.Sizes)
+		{
+			s << qint32(Size);
+		}
+		return addBlob(blobData(SplitterBlob, Children, Payload), Children);
+	}
+
+	s << Node.Area.CurrentDockWidget << qint32(Node.Area.AllowedAreas)
+	  << qint32(Node.Area.Flags);
+	internal::writeDockWidgetsBinary(s, Node.Area.DockWidgets);
+	return addBlob(blobData(AreaBlob, {}, Payload), {});
+}
+
+
+//============================================================================
+QByteArray DockPerspectiveStorePrivate::addContainer(const DockContainerState& Container)
+{
+	QVector<QByteArray> Children;
+	if (!Container.Nodes.isEmpty())
+	{
+		int Index = 0;
+		Children.append(addNode(Container.Nodes, Index));
+	}
+
+	QByteArray Payload;
+	QDataStream s(&Payload, QIODevice::WriteOnly);
+	s.setVersion(StoreStreamVersion);
+	s << Container.Floating << Container.Geometry;
+	s << qint32(Container.SideBars.count());
+	for (const auto& SideBar : Container.SideBars)
+	{
+		s << qint32(SideBar.Location);
+		internal::writeDockWidgetsBinary(s, SideBar.DockWidgets);
+	}
+	return addBlob(blobData(ContainerBlob, Children, Payload), Children);
+}
+
+
+//============================================================================
+QByteArray DockPerspectiveStorePrivate::addState(const DockingState& State)
+{
+	QVector<QByteArray> Children;
+	for (const auto& Container : State.Containers)
+	{
+		Children.append(addContainer(Container));
+	}
+
+	QByteArray Payload;
+	QDataStream s(&Payload, QIODevice::WriteOnly);
+	s.setVersion(StoreStreamVersion);
+	s << State.HasUserVersion << qint32(State.UserVersion) << State.CentralWidget;
+	return addBlob(blobData(StateBlob, Children, Payload), Children);
+}
+
+
+//============================================================================
+bool DockPerspectiveStorePrivate::expandNode(const QByteArray& Hash,
+	QVector<DockLayoutNode>& Nodes) const
+{
+	auto it = Blobs.constFind(Hash);
+	if (it == Blobs.constEnd())
+	{
+		return false;
+	}
+
+	QDataStream s(it->Data);
+	s.setVersion(StoreStreamVersion);
+	quint8 Type;
+	QVector<QByteArray> Children;
+	if (!readBlobHeader(s, Type, Children))
+	{
+		return false;
+	}
+
+	DockLayoutNode Node;
+	if (Type == AreaBlob)
+	{
+		qint32 AllowedAreas;
+		qint32 Flags;
+		s >> Node.Area.CurrentDockWidget >> AllowedAreas >> Flags;
+		Node.Type = DockLayoutNode::AreaNode;
+		Node.Area.AllowedAreas = AllowedAreas;
+		Node.Area.Flags = Flags;
+		if (!internal::readDockWidgetsBinary(s, Node.Area.DockWidgets))
+		{
+			return false;
+		}
+		Nodes.append(Node);
+		return true;
+	}
+
+	if (Type != SplitterBlob)
+	{
+		return false;
+	}
+
+	quint8 Orientation;
+	int SizeCount;
+	s >> Orientation;
+	if (!internal::readBinaryCount(s, SizeCount)
+	 || (Orientation != Qt::Horizontal && Orientation != Qt::Vertical))
+	{
+		return false;
+	}
+
+	Node.Type = DockLayoutNode::SplitterNode;
+	Node.Orientation = static_cast<Qt::Orientation>(Orientation);
+	Node.ChildCount = Children.count();
+	for (int i = 0; i < SizeCount; ++i)
+	{
+		qint32 Size;
+		s >> Size;
+		Node.Sizes.append(Size);
+	}
+	if (s.status() != QDataStream::Ok)
+	{
+		return false;
+	}
+
+	Nodes.append(Node);
+	for (const auto& Child : Children)
+	{
+		if (!expandNode(Child, Nodes))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool DockPerspectiveStorePrivate::expandContainer(const QByteArray& Hash,
+	DockContainerState& Container) const
+{
+	auto it = Blobs.constFind(Hash);
+	if (it == Blobs.constEnd())
+	{
+		return false;
+	}
+
+	QDataStream s(it->Data);
+	s.setVersion(StoreStreamVersion);
+	quint8 Type;
+	QVector<QByteArray> Children;
+	if (!readBlobHeader(s, Type, Children) || Type != ContainerBlob
+	 || Children.count() > 1)
+	{
+		return false;
+	}
+
+	s >> Container.Floating >> Container.Geometry;
+	int SideBarCount;
+	if (!internal::readBinaryCount(s, SideBarCount))
+	{
+		return false;
+	}
+
+	Container.SideBars.resize(SideBarCount);
+	for (auto& SideBar : Container.SideBars)
+	{
+		qint32 Location;
+		s >> Location;
+		SideBar.Location = static_cast<SideBarLocation>(Location);
+		if (!internal::readDockWidgetsBinary(s, SideBar.DockWidgets))
+		{
+			return false;
+		}
+	}
+
+	return Children.isEmpty() || expandNode(Children.first(), Container.Nodes);
+}
+
+
+//============================================================================
+bool DockPerspectiveStorePrivate::expandState(const QByteArray& Hash,
+	DockingState& State) const
+{
+	auto it = Blobs.constFind(Hash);
+	if (it == Blobs.constEnd())
+	{
+		return false;
+	}
+
+	QDataStream s(it->Data);
+	s.setVersion(StoreStreamVersion);
+	quint8 Type;
+	QVector<QByteArray> Children;
+	if (!readBlobHeader(s, Type, Children) || Type != StateBlob)
+	{
+		return false;
+	}
+
+	qint32 UserVersion;
+	s >> State.HasUserVersion >> UserVersion >> State.CentralWidget;
+	if (s.status() != QDataStream::Ok)
+	{
+		return false;
+	}
+
+	State.FileVersion = DockingState::CurrentVersion;
+	State.UserVersion = UserVersion;
+	State.Containers.resize(Children.count());
+	for (int i = 0; i < Children.count(); ++i)
+	{
+		if (!expandContainer(Children[i], State.Containers[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+CDockPerspectiveStore::CDockPerspectiveStore() :
+	d(new DockPerspectiveStorePrivate())
+{
+
+}
+
+
+//============================================================================
+CDockPerspectiveStore::~CDockPerspectiveStore()
+{
+	delete d;
+}
+
+
+//============================================================================
+void CDockPerspectiveStore::insert(const QString& Name, const DockingState& State)
+{
+	// We add the new state before we release the old one, so that the blobs
+	// shared by both states are not removed and added again
+	auto Hash = d->addState(State);
+	auto it = d->Perspectives.find(Name);
+	if (it != d->Perspectives.end())
+	{
+		d->releaseBlob(it.value());
+		it.value() = Hash;
+	}
+	else
+	{
+		d->Perspectives.insert(Name, Hash);
+	}
+}
+
+
+//============================================================================
+bool CDockPerspectiveStore::remove(const QString& Name)
+{
+	auto it = d->Perspectives.find(Name);
+	if (it == d->Perspectives.end())
+	{
+		return false;
+	}
+
+	d->releaseBlob(it.value());
+	d->Perspectives.erase(it);
+	return true;
+}
+
+
+//============================================================================
+void CDockPerspectiveStore::clear()
+{
+	d->Blobs.clear();
+	d->Perspectives.clear();
+}
+
+
+//============================================================================
+bool CDockPerspectiveStore::contains(const QString& Name) const
+{
+	return d->Perspectives.contains(Name);
+}
+
+
+//============================================================================
+QStringList CDockPerspectiveStore::names() const
+{
+	return d->Perspectives.keys();
+}
+
+
+//============================================================================
+int CDockPerspectiveStore::count() const
+{
+	return d->Perspectives.count();
+}
+
+
+//============================================================================
+bool CDockPerspectiveStore::state(const QString& Name, DockingState& State) const
+{
+	auto it = d->Perspectives.constFind(Name);
+	if (it == d->Perspectives.constEnd())
+	{
+		return false;
+	}
+
+	return d->expandState(it.value(), State);
+}
+
+
+//============================================================================
+QByteArray CDockPerspectiveStore::toByteArray() const
+{
+	QByteArray Data;
+	QDataStream s(&Data, QIODevice::WriteOnly);
+	s.setVersion(StoreStreamVersion);
+	s.writeRawData(StoreMagic, StoreMagicSize);
+	s << StoreVersion;
+
+	// We sort the blobs by hash to get the same data for the same store
+	auto Hashes = d->Blobs.keys();
+	std::sort(Hashes.begin(), Hashes.end());
+	s << qint32(Hashes.count());
+	for (const auto& Hash : Hashes)
+	{
+		s << d->Blobs[Hash].Data;
+	}
+
+	s << qint32(d->Perspectives.count());
+	for (auto it = d->Perspectives.constBegin(); it != d->Perspectives.constEnd(); ++it)
+	{
+		s << it.key() << it.value();
+	}
+
+	return Data;
+}
+
+
+//============================================================================
+bool CDockPerspectiveStore::isStoreData(const QByteArray& Data)
+{
+	return Data.startsWith(QByteArray::fromRawData(StoreMagic, StoreMagicSize));
+}
+
+
+//============================================================================
+bool CDockPerspectiveStore::fromByteArray(const QByteArray& Data)
+{
+	clear();
+	if (!isStoreData(Data))
+	{
+		return false;
+	}
+
+	QDataStream s(Data);
+	s.setVersion(StoreStreamVersion);
+	s.skipRawData(StoreMagicSize);
+	quint32 Version;
+	s >> Version;
+	int BlobCount;
+	if (s.status() != QDataStream::Ok || Version > StoreVersion
+	 || !internal::readBinaryCount(s, BlobCount))
+	{
+		return false;
+	}
+
+	// The hashes are not stored but calculated from the blob data. So
+	// corrupted blobs are detected as missing blobs below
+	QHash<QByteArray, StoreBlob> Blobs;
+	Blobs.reserve(BlobCount);
+	for (int i = 0; i < BlobCount; ++i)
+	{
+		StoreBlob Blob;
+		s >> Blob.Data;
+		QDataStream BlobStream(Blob.Data);
+		BlobStream.setVersion(StoreStreamVersion);
+		quint8 Type;
+		if (s.status() != QDataStream::Ok
+		 || !readBlobHeader(BlobStream, Type, Blob.Children))
+		{
+			return false;
+		}
+		Blobs.insert(QCryptographicHash::hash(Blob.Data, QCryptographicHash::Sha1), Blob);
+	}
+
+	int PerspectiveCount;
+	if (!internal::readBinaryCount(s, PerspectiveCount))
+	{
+		return false;
+	}
+
+	QMap<QString, QByteArray> Perspectives;
+	for (int i = 0; i < PerspectiveCount; ++i)
+	{
+		QString Name;
+		QByteArray Hash;
+		s >> Name >> Hash;
+		Perspectives.insert(Name, Hash);
+	}
+	if (s.status() != QDataStream::Ok)
+	{
+		return false;
+	}
+
+	// Now we can calculate the reference counts and check, that all
+	// referenced blobs exist
+	for (auto it = Blobs.begin(); it != Blobs.end(); ++it)
+	{
+		for (const auto& Child : it->Children)
+		{
+			auto ChildIt = Blobs.find(Child);
+			if (ChildIt == Blobs.end())
+			{
+				return false;
+			}
+			ChildIt->RefCount++;
+		}
+	}
+
+	for (const auto& Hash : Perspectives)
+	{
+		auto it = Blobs.find(Hash);
+		if (it == Blobs.end())
+		{
+			return false;
+		}
+		it->RefCount++;
+	}
+
+	d->Blobs = Blobs;
+	d->Perspectives = Perspectives;
+
+	// Remove blobs that are not referenced by any perspective
+	QVector<QByteArray> UnusedBlobs;
+	for (auto it = d->Blobs.constBegin(); it != d->Blobs.constEnd(); ++it)
+	{
+		if (!it->RefCount)
+		{
+			UnusedBlobs.append(it.key());
+		}
+	}
+
+	for (const auto& Hash : UnusedBlobs)
+	{
+		d->Blobs[Hash].RefCount = 1;
+		d->releaseBlob(Hash);
+	}
+
+	return true;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockPerspectiveStore.cpp
@@ -0,0 +1,104 @@
+#ifndef DockPerspectiveStoreH
+#define DockPerspectiveStoreH
+//============================================================================
+/// \file   DockPerspectiveStore.h
+/// \date   16.10.2026
+/// \brief  Declaration of CDockPerspectiveStore
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QStringList>
+
+#include "DockingState.h"
+
+namespace ads
+{
+struct DockPerspectiveStorePrivate;
+
+/**
+ * Content addressed storage for the perspectives of the dock manager.
+ * Each perspective is split into blobs for the dock areas, splitters and
+ * containers. Every blob is stored only once and is referenced by the
+ * hash of its content. Perspectives that share complete containers or
+ * splitter subtrees store these parts only once. The blobs are reference
+ * counted and are released, if no perspective references them anymore.
+ */
+class CDockPerspectiveStore
+{
+	Q_DISABLE_COPY(CDockPerspectiveStore)
+private:
+	DockPerspectiveStorePrivate* d; ///< private data (pimpl)
+
+public:
+	/**
+	 * Default Constructor
+	 */
+	CDockPerspectiveStore();
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDockPerspectiveStore();
+
+	/**
+	 * Stores the given state under the given perspective name. An existing
+	 * perspective with the same name is replaced.
+	 */
+	void insert(const QString& Name, const DockingState& State);
+
+	/**
+	 * Removes the perspective with the given name. Returns false, if there
+	 * is no perspective with this name
+	 */
+	bool remove(const QString& Name);
+
+	/**
+	 * Removes all perspectives
+	 */
+	void clear();
+
+	/**
+	 * Returns true, if the store contains a perspective with the given name
+	 */
+	bool contains(const QString& Name) const;
+
+	/**
+	 * Returns the names of all perspectives in alphabetical order
+	 */
+	QStringList names() const;
+
+	/**
+	 * Returns the number of perspectives
+	 */
+	int count() const;
+
+	/**
+	 * Expands the perspective with the given name into State. Returns false,
+	 * if there is no perspective with this name.
+	 */
+	bool state(const QString& Name, DockingState& State) const;
+
+	/**
+	 * Serializes the complete store including all blobs. Shared blobs are
+	 * written only once.
+	 */
+	QByteArray toByteArray() const;
+
+	/**
+	 * Returns true, if Data starts with the header written by toByteArray()
+	 */
+	static bool isStoreData(const QByteArray& Data);
+
+	/**
+	 * Replaces the content of this store with the data created by
+	 * toByteArray(). Returns false and leaves the store empty, if the data
+	 * is invalid.
+	 */
+	bool fromByteArray(const QByteArray& Data);
+}; // class CDockPerspectiveStore
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockPerspectiveStoreH
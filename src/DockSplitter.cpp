@@ -33,6 +33,7 @@
 #include <QChildEvent>
 #include <QVariant>
 #include "DockAreaWidget.h"
+#include "DockContainerWidget.h"
 
 namespace ads
 {
@@ -42,9 +43,23 @@ namespace ads
 struct DockSplitterPrivate
 {
 	CDockSplitter* _this;
-	int VisibleContentCount = 0;
+	int VisibleContentCount = -1; ///< -1 indicates, that the count needs to be calculated
+	QList<int> LastSizes; ///< sizes at the last resize event
 
 	DockSplitterPrivate(CDockSplitter* _public) : _this(_public) {}
+
+	/**
+	 * Marks the layout of the dock container that contains this splitter
+	 * as changed
+	 */
+	void markLayoutChanged()
+	{
+		auto Container = internal::findParent<CDockContainerWidget*>(_this);
+		if (Container)
+		{
+			Container->markLayoutChanged();
+		}
+	}
 };
 
 //============================================================================
@@ -54,6 +69,7 @@ CDockSplitter::CDockSplitter(QWidget *parent)
 {
     setProperty("ads-splitter", QVariant(true));
 	setChildrenCollapsible(false);
+	connect(this, &QSplitter::splitterMoved, [this](){ d->markLayoutChanged(); });
 }
 
 
@@ -62,7 +78,7 @@ CDockSplitter::CDockSplitter(Qt::Orientation orientation, QWidget *parent)
 	: QSplitter(orientation, parent),
 	  d(new DockSplitterPrivate(this))
 {
-
+	connect(this, &QSplitter::splitterMoved, [this](){ d->markLayoutChanged(); });
 }
 
 //============================================================================
@@ -73,19 +89,78 @@ CDockSplitter::~CDockSplitter()
 }
 
 
+//============================================================================
+bool CDockSplitter::event(QEvent* e)
+{
+	switch (e->type())
+	{
+	case QEvent::ChildAdded:
+	case QEvent::ChildRemoved:
+		d->VisibleContentCount = -1;
+		d->markLayoutChanged();
+		break;
+
+	default:
+		break;
+	}
+
+	bool Result = QSplitter::event(e);
+	// Resize events are also delivered, if the size does not really change,
+	// so we only mark the layout as changed, if the sizes changed
+	if (e->type() == QEvent::Resize)
+	{
+		auto Sizes = sizes();
+		if (Sizes != d->LastSizes)
+		{
+			d->LastSizes = Sizes;
+			d->markLayoutChanged();
+		}
+	}
+	return Result;
+}
+
+
 //============================================================================
 bool CDockSplitter::hasVisibleContent() const
 {
-	// TODO Cache or precalculate this to speed up
-	for (int i = 0; i < count(); ++i)
+	if (d->VisibleContentCount < 0)
 	{
-		if (!widget(i)->isHidden())
+		d->VisibleContentCount = 0;
+		for (int i = 0; i < count(); ++i)
 		{
-			return true;
+			d->VisibleContentCount += widget(i)->isHidden() ? 0 : 1;
 		}
 	}
 
-	return false;
+	return d->VisibleContentCount > 0;
+}
+
+
+//============================================================================
+void CDockSplitter::onContentVisibilityChanged(QWidget* Content, bool Visible)
+{
+	if (d->VisibleContentCount < 0 || indexOf(Content) < 0)
+	{
+		return;
+	}
+
+	d->VisibleContentCount += Visible ? 1 : -1;
+}
+
+
+//============================================================================
+void CDockSplitter::setVisible(bool Visible)
+{
+	bool WasHidden = isHidden();
+	QSplitter::setVisible(Visible);
+	if (WasHidden != isHidden())
+	{
+		auto Splitter = qobject_cast<CDockSplitter*>(parentWidget());
+		if (Splitter)
+		{
+			Splitter->onContentVisibilityChanged(this, WasHidden);
+		}
+	}
 }
 
 
@@ -47,6 +47,20 @@ class ADS_EXPORT CDockSplitter : public QSplitter
 private:
 	DockSplitterPrivate* d;
 	friend struct DockSplitterPrivate;
+	friend class CDockAreaWidget;
+
+protected:
+	/**
+	 * Marks the layout of the parent dock container as changed, if widgets
+	 * are added or removed or if the splitter sizes change
+	 */
+	virtual bool event(QEvent* e) override;
+
+	/**
+	 * Called by the content widgets of this splitter if they are shown or
+	 * hidden to update the visible content count incrementally
+	 */
+	void onContentVisibilityChanged(QWidget* Content, bool Visible);
 
 public:
 	CDockSplitter(QWidget *parent = Q_NULLPTR);
@@ -62,6 +76,11 @@ public:
 	 */
 	bool hasVisibleContent() const;
 
+	/**
+	 * Updates the visible content count of the parent splitter
+	 */
+	virtual void setVisible(bool Visible) override;
+
 	/**
 	 * Returns first widget or nullptr if splitter is empty
 	 */
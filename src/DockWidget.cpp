@@ -752,6 +752,10 @@ void CDockWidget::toggleViewInternal(bool Open)
 		? DockContainer->topLevelDockWidget() : nullptr;
 
 	d->Closed = !Open;
+	if (DockContainer)
+	{
+		DockContainer->markLayoutChanged();
+	}
 
 	if (Open)
 	{
@@ -797,7 +801,10 @@ void CDockWidget::toggleViewInternal(bool Open)
 	{
 		Q_EMIT closed();
 	}
-	Q_EMIT viewToggled(Open);
+	if (!d->DockManager || !d->DockManager->deferViewToggled(this))
+	{
+		Q_EMIT viewToggled(Open);
+	}
 }
 
 
@@ -1058,7 +1065,15 @@ void CDockWidget::emitTopLevelChanged(bool Floating)
 	if (Floating != d->IsFloatingTopLevel)
 	{
 		d->IsFloatingTopLevel = Floating;
-		Q_EMIT topLevelChanged(d->IsFloatingTopLevel);
+		if (d->DockManager && d->DockManager->deferTopLevelChanged(this))
+		{
+			// The tool bar style is updated via the deferred signal otherwise
+			setToolbarFloatingStyle(Floating);
+		}
+		else
+		{
+			Q_EMIT topLevelChanged(d->IsFloatingTopLevel);
+		}
 	}
 }
 
@@ -1066,7 +1081,17 @@ void CDockWidget::emitTopLevelChanged(bool Floating)
 //============================================================================
 void CDockWidget::setClosedState(bool Closed)
 {
+	if (d->Closed == Closed)
+	{
+		return;
+	}
+
 	d->Closed = Closed;
+	auto DockContainer = dockContainer();
+	if (DockContainer)
+	{
+		DockContainer->markLayoutChanged();
+	}
 }
 
 
@@ -75,9 +75,11 @@ struct DockWidgetTabPrivate
 	IFloatingWidget* FloatingWidget = nullptr;
 	QIcon Icon;
 	QAbstractButton* CloseButton = nullptr;
+	bool CloseButtonVisibilityApplied = false;
 	QSpacerItem* IconTextSpacer;
 	QPoint TabDragStartPosition;
 	QSize IconSize;
+	internal::CDragMoveCoalescer FloatingWidgetMove;
 
 	/**
 	 * Private data constructor
@@ -135,6 +137,24 @@ struct DockWidgetTabPrivate
 		}
 	}
 
+	/**
+	 * Returns true, if the space of the close button needs to be reserved
+	 * even if the close button is hidden
+	 */
+	bool closeButtonRetainsSize() const
+	{
+		return DockWidget->features().testFlag(CDockWidget::DockWidgetClosable)
+			&& testConfigFlag(CDockManager::RetainTabSizeWhenCloseButtonHidden);
+	}
+
+	/**
+	 * Creates the close button and inserts it into the tab layout, if it
+	 * does not exist yet.
+	 * In dock areas with hundreds of tabs, most tabs never show a close
+	 * button, so the button is only created, when the tab really needs it
+	 */
+	void ensureCloseButton();
+
 	/**
 	 * Update the close button visibility from current feature/config
 	 */
@@ -144,7 +164,14 @@ struct DockWidgetTabPrivate
 		bool ActiveTabHasCloseButton = testConfigFlag(CDockManager::ActiveTabHasCloseButton);
 		bool AllTabsHaveCloseButton = testConfigFlag(CDockManager::AllTabsHaveCloseButton);
 		bool TabHasCloseButton = (ActiveTabHasCloseButton && active) | AllTabsHaveCloseButton;
-		CloseButton->setVisible(DockWidgetClosable && TabHasCloseButton);
+		bool Visible = DockWidgetClosable && TabHasCloseButton;
+		CloseButtonVisibilityApplied = true;
+		if (!CloseButton && !Visible && !closeButtonRetainsSize())
+		{
+			return;
+		}
+		ensureCloseButton();
+		CloseButton->setVisible(Visible);
 	}
 
 	/**
@@ -153,10 +180,14 @@ struct DockWidgetTabPrivate
 	 */
 	void updateCloseButtonSizePolicy()
 	{
-		auto Features = DockWidget->features();
+		bool RetainSize = closeButtonRetainsSize();
+		if (!CloseButton && !RetainSize)
+		{
+			return;
+		}
+		ensureCloseButton();
 		auto SizePolicy = CloseButton->sizePolicy();
-		SizePolicy.setRetainSizeWhenHidden(Features.testFlag(CDockWidget::DockWidgetClosable)
-			&& testConfigFlag(CDockManager::RetainTabSizeWhenCloseButtonHidden));
+		SizePolicy.setRetainSizeWhenHidden(RetainSize);
 		CloseButton->setSizePolicy(SizePolicy);
 	}
 
@@ -169,7 +200,7 @@ struct DockWidgetTabPrivate
 		}
 		else
 		{
-			auto w = new CFloatingDragPreview(Widget);
+			auto w = CFloatingDragPreview::create(Widget);
 			_this->connect(w, &CFloatingDragPreview::draggingCanceled, [=]()
 			{
 				DragState = DraggingInactive;
@@ -234,7 +265,14 @@ struct DockWidgetTabPrivate
 
 //============================================================================
 DockWidgetTabPrivate::DockWidgetTabPrivate(CDockWidgetTab* _public) :
-	_this(_public)
+	_this(_public),
+	FloatingWidgetMove(_public, [this]()
+	{
+		if (isDraggingState(DraggingFloatingWidget))
+		{
+			FloatingWidget->moveFloating();
+		}
+	})
 {
 
 }
@@ -257,16 +295,6 @@ void DockWidgetTabPrivate::createLayout()
 	TitleLabel->setAlignment(Qt::AlignCenter);
 	_this->connect(TitleLabel, SIGNAL(elidedChanged(bool)), SIGNAL(elidedChanged(bool)));
 
-
-	CloseButton = createCloseButton();
-	CloseButton->setObjectName("tabCloseButton");
-	internal::setButtonIcon(CloseButton, QStyle::SP_TitleBarCloseButton, TabCloseIcon);
-    CloseButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-    CloseButton->setFocusPolicy(Qt::NoFocus);
-    updateCloseButtonSizePolicy();
-	internal::setToolTip(CloseButton, QObject::tr("Close Tab"));
-	_this->connect(CloseButton, SIGNAL(clicked()), SIGNAL(closeRequested()));
-
 	QFontMetrics fm(TitleLabel->font());
 	int Spacing = qRound(fm.height() / 4.0);
 
@@ -277,11 +305,36 @@ void DockWidgetTabPrivate::createLayout()
 	_this->setLayout(Layout);
 	Layout->addWidget(TitleLabel, 1);
 	Layout->addSpacing(Spacing);
-	Layout->addWidget(CloseButton);
+	// The close button is inserted here by ensureCloseButton()
 	Layout->addSpacing(qRound(Spacing * 4.0 / 3.0));
 	Layout->setAlignment(Qt::AlignCenter);
 
 	TitleLabel->setVisible(true);
+	updateCloseButtonSizePolicy();
+}
+
+
+//============================================================================
+void DockWidgetTabPrivate::ensureCloseButton()
+{
+	if (CloseButton)
+	{
+		return;
+	}
+
+	CloseButton = createCloseButton();
+	CloseButton->setObjectName("tabCloseButton");
+	internal::setButtonIcon(CloseButton, QStyle::SP_TitleBarCloseButton, TabCloseIcon);
+	QSizePolicy SizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	SizePolicy.setRetainSizeWhenHidden(closeButtonRetainsSize());
+	CloseButton->setSizePolicy(SizePolicy);
+	CloseButton->setFocusPolicy(Qt::NoFocus);
+	internal::setToolTip(CloseButton, QObject::tr("Close Tab"));
+	_this->connect(CloseButton, SIGNAL(clicked()), SIGNAL(closeRequested()));
+
+	// Insert the button in front of the trailing spacing of the layout
+	QBoxLayout* Layout = qobject_cast<QBoxLayout*>(_this->layout());
+	Layout->insertWidget(Layout->count() - 1, CloseButton);
 }
 
 //============================================================================
@@ -398,6 +451,9 @@ void CDockWidgetTab::mouseReleaseEvent(QMouseEvent* ev)
 {
 	if (ev->button() == Qt::LeftButton)
 	{
+		// The floating widget needs to be at the final position before
+		// the drop target is evaluated
+		d->FloatingWidgetMove.flush();
 		auto CurrentDragState = d->DragState;
 		d->GlobalDragStartMousePosition = QPoint();
 		d->DragStartMousePosition = QPoint();
@@ -458,7 +514,7 @@ void CDockWidgetTab::mouseMoveEvent(QMouseEvent* ev)
     // move floating window
     if (d->isDraggingState(DraggingFloatingWidget))
     {
-        d->FloatingWidget->moveFloating();
+        d->FloatingWidgetMove.request();
         Super::mouseMoveEvent(ev);
         return;
     }
@@ -785,6 +841,13 @@ bool CDockWidgetTab::event(QEvent *e)
 	{
 		d->updateIcon();
 	}
+	else if (e->type() == QEvent::Show && !d->CloseButtonVisibilityApplied)
+	{
+		// A tab that is shown before its close button visibility has been
+		// updated shows the close button
+		d->ensureCloseButton();
+		d->CloseButton->show();
+	}
 	return Super::event(e);
 }
 
@@ -807,7 +870,7 @@ void CDockWidgetTab::setElideMode(Qt::TextElideMode mode)
 //============================================================================
 void CDockWidgetTab::updateStyle()
 {
-	internal::repolishStyle(this, internal::RepolishDirectChildren);
+	internal::scheduleRepolishStyle(this, internal::RepolishDirectChildren);
 }
 
 
@@ -160,7 +160,8 @@ public:
 	void setElideMode(Qt::TextElideMode mode);
 
 	/**
-	 * Update stylesheet style if a property changes
+	 * Update stylesheet style if a property changes.
+	 * The update is deferred and executed once before the next paint
 	 */
 	void updateStyle();
 
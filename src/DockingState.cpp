@@ -0,0 +1,557 @@
+//============================================================================
+/// \file   DockingState.cpp
+/// \date   16.10.2026
+/// \brief  Implementation of the docking state serialization
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockingState.h"
+
+#include <QXmlStreamWriter>
+#include <QDataStream>
+#include <QIODevice>
+#include <QBuffer>
+
+
+#if QT_VERSION < 0x050900
+
+inline char toHexLower(uint value)
+{
+    return "0123456789abcdef"[value & 0xF];
+}
+
+QByteArray qByteArrayToHex(const QByteArray& src, char separator)
+{
+    if(src.size() == 0)
+        return QByteArray();
+
+    const int length = separator ? (src.size() * 3 - 1) : (src.size() * 2);
+    QByteArray hex(length, Qt::Uninitialized);
+    char *hexData = hex.data();
+    const uchar *data = reinterpret_cast<const uchar *>(src.data());
+    for (int i = 0, o = 0; i < src.size(); ++i) {
+        hexData[o++] = toHexLower(data[i] >> 4);
+        hexData[o++] = toHexLower(data[i] & 0xf);
+
+        if ((separator) && (o < length))
+            hexData[o++] = separator;
+    }
+    return hex;
+}
+#endif
+
+namespace ads
+{
+/**
+ * The binary format starts with this magic header followed by the
+ * binary format version
+ */
+static const char BinaryMagic[] = {'A', 'D', 'S', 'B'};
+static const int BinaryMagicSize = sizeof(BinaryMagic);
+
+/**
+ * Data stream version used for the binary format. We use a fixed version
+ * to get the same binary data with Qt 5 and Qt 6
+ */
+static const int BinaryStreamVersion = QDataStream::Qt_5_6;
+
+/**
+ * Lists are filled entry by entry while reading. We reserve at most this
+ * number of entries in advance, because the counts read from sequential
+ * devices can not be validated against the size of the data.
+ */
+static const int MaxPreallocatedCount = 1024;
+
+
+//============================================================================
+static void writeSplitterXml(QXmlStreamWriter& s, const QVector<DockLayoutNode>& Nodes,
+	int& Index);
+
+static void writeNodeXml(QXmlStreamWriter& s, const QVector<DockLayoutNode>& Nodes,
+	int& Index)
+{
+	if (Nodes[Index].Type == DockLayoutNode::SplitterNode)
+	{
+		writeSplitterXml(s, Nodes, Index);
+	}
+	else
+	{
+		Nodes[Index++].Area.writeXml(s);
+	}
+}
+
+
+//============================================================================
+static void writeSplitterXml(QXmlStreamWriter& s, const QVector<DockLayoutNode>& Nodes,
+	int& Index)
+{
+	const auto& Node = Nodes[Index++];
+	s.writeStartElement("Splitter");
+	s.writeAttribute("Orientation", (Node.Orientation == Qt::Horizontal) ? "|" : "-");
+	s.writeAttribute("Count", QString::number(Node.Sizes.count()));
+		for (int i = 0; i < Node.ChildCount; ++i)
+		{
+			writeNodeXml(s, Nodes, Index);
+		}
+
+		s.writeStartElement("Sizes");
+		for (auto Size : Node.Sizes)
+		{
+			s.writeCharacters(QString::number(Size) + " ");
+		}
+		s.writeEndElement();
+	s.writeEndElement();
+}
+
+
+//============================================================================
+void DockWidgetState::writeXml(QXmlStreamWriter& s) const
+{
+	s.writeStartElement("Widget");
+	s.writeAttribute("Name", Name);
+	s.writeAttribute("Closed", QString::number(Closed ? 1 : 0));
+	s.writeEndElement();
+}
+
+
+//============================================================================
+void DockAreaState::writeXml(QXmlStreamWriter& s) const
+{
+	s.writeStartElement("Area");
+	s.writeAttribute("Tabs", QString::number(DockWidgets.count()));
+	s.writeAttribute("Current", CurrentDockWidget);
+	if (AllowedAreas != AllDockAreas)
+	{
+		s.writeAttribute("AllowedAreas", QString::number(AllowedAreas, 16));
+	}
+
+	if (Flags != 0)
+	{
+		s.writeAttribute("Flags", QString::number(Flags, 16));
+	}
+
+	for (const auto& DockWidget : DockWidgets)
+	{
+		DockWidget.writeXml(s);
+	}
+	s.writeEndElement();
+}
+
+
+//============================================================================
+void AutoHideSideBarState::writeXml(QXmlStreamWriter& s) const
+{
+	s.writeStartElement("SideBar");
+	s.writeAttribute("Area", QString::number(Location));
+	s.writeAttribute("Tabs", QString::number(DockWidgets.count()));
+	for (const auto& DockWidget : DockWidgets)
+	{
+		s.writeStartElement("Widget");
+		s.writeAttribute("Name", DockWidget.Name);
+		s.writeAttribute("Closed", QString::number(DockWidget.Closed ? 1 : 0));
+		s.writeAttribute("Size", QString::number(DockWidget.Size));
+		s.writeEndElement();
+	}
+	s.writeEndElement();
+}
+
+
+//============================================================================
+void DockContainerState::writeXml(QXmlStreamWriter& s) const
+{
+	s.writeStartElement("Container");
+	s.writeAttribute("Floating", QString::number(Floating ? 1 : 0));
+	if (Floating)
+	{
+#if QT_VERSION < 0x050900
+        s.writeTextElement("Geometry", qByteArrayToHex(Geometry, ' '));
+#else
+		s.writeTextElement("Geometry", Geometry.toHex(' '));
+#endif
+	}
+
+	if (!Nodes.isEmpty())
+	{
+		int Index = 0;
+		writeNodeXml(s, Nodes, Index);
+	}
+
+	for (const auto& SideBar : SideBars)
+	{
+		SideBar.writeXml(s);
+	}
+	s.writeEndElement();
+}
+
+
+//============================================================================
+/**
+ * Checks that the pre-order node list starting at Index describes a complete
+ * subtree and moves Index behind the subtree
+ */
+static bool validateNode(const QVector<DockLayoutNode>& Nodes, int& Index)
+{
+	if (Index >= Nodes.count())
+	{
+		return false;
+	}
+
+	const auto& Node = Nodes[Index++];
+	if (Node.Type != DockLayoutNode::SplitterNode)
+	{
+		return true;
+	}
+
+	for (int i = 0; i < Node.ChildCount; ++i)
+	{
+		if (!validateNode(Nodes, Index))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool DockContainerState::hasValidLayout() const
+{
+	if (Nodes.isEmpty())
+	{
+		return true;
+	}
+
+	int Index = 0;
+	return validateNode(Nodes, Index) && Index == Nodes.count();
+}
+
+
+//============================================================================
+bool DockingState::isValid() const
+{
+	for (const auto& Container : Containers)
+	{
+		if (!Container.hasValidLayout())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+QByteArray DockingState::toXml(bool AutoFormatting) const
+{
+	QByteArray xmldata;
+	QBuffer Buffer(&xmldata);
+	Buffer.open(QIODevice::WriteOnly);
+	writeXml(&Buffer, AutoFormatting);
+	return xmldata;
+}
+
+
+//============================================================================
+bool DockingState::writeXml(QIODevice* Device, bool AutoFormatting) const
+{
+    QXmlStreamWriter s(Device);
+	s.setAutoFormatting(AutoFormatting);
+    s.writeStartDocument();
+		s.writeStartElement("QtAdvancedDockingSystem");
+		// The state always contains the splitter orientation of the current
+		// file version, even if it has been read from an older file
+		s.writeAttribute("Version", QString::number(CurrentVersion));
+		if (HasUserVersion)
+		{
+			s.writeAttribute("UserVersion", QString::number(UserVersion));
+		}
+		s.writeAttribute("Containers", QString::number(Containers.count()));
+		if (!CentralWidget.isEmpty())
+		{
+			s.writeAttribute("CentralWidget", CentralWidget);
+		}
+		for (const auto& Container : Containers)
+		{
+			Container.writeXml(s);
+		}
+
+		s.writeEndElement();
+    s.writeEndDocument();
+    return !s.hasError();
+}
+
+
+//============================================================================
+void internal::writeDockWidgetsBinary(QDataStream& s, const QVector<DockWidgetState>& DockWidgets)
+{
+	s << qint32(DockWidgets.count());
+	for (const auto& DockWidget : DockWidgets)
+	{
+		s << DockWidget.Name << DockWidget.Closed << qint32(DockWidget.Size);
+	}
+}
+
+
+//============================================================================
+QByteArray DockingState::toBinary() const
+{
+	QByteArray Data;
+	QBuffer Buffer(&Data);
+	Buffer.open(QIODevice::WriteOnly);
+	writeBinary(&Buffer);
+	return Data;
+}
+
+
+//============================================================================
+bool DockingState::writeBinary(QIODevice* Device) const
+{
+	QDataStream s(Device);
+	s.setVersion(BinaryStreamVersion);
+	s.writeRawData(BinaryMagic, BinaryMagicSize);
+	s << quint32(CurrentBinaryVersion);
+	s << HasUserVersion << qint32(UserVersion) << CentralWidget;
+	s << qint32(Containers.count());
+	for (const auto& Container : Containers)
+	{
+		s << Container.Floating << Container.Geometry;
+		s << qint32(Container.Nodes.count());
+		for (const auto& Node : Container.Nodes)
+		{
+			s << quint8(Node.Type);
+			if (Node.Type == DockLayoutNode::SplitterNode)
+			{
+				s << quint8(Node.Orientation) << qint32(Node.ChildCount);
+				s << qint32(Node.Sizes.count());
+				for (auto Size : Node.Sizes)
+				{
+					s << qint32(Size);
+				}
+			}
+			else
+			{
+				s << Node.Area.CurrentDockWidget << qint32(Node.Area.AllowedAreas)
+				  << qint32(Node.Area.Flags);
+				internal::writeDockWidgetsBinary(s, Node.Area.DockWidgets);
+			}
+		}
+
+		s << qint32(Container.SideBars.count());
+		for (const auto& SideBar : Container.SideBars)
+		{
+			s << qint32(SideBar.Location);
+			internal::writeDockWidgetsBinary(s, SideBar.DockWidgets);
+		}
+	}
+
+	return s.status() == QDataStream::Ok;
+}
+
+
+//============================================================================
+bool DockingState::isBinary(const QByteArray& Data)
+{
+	return Data.startsWith(QByteArray::fromRawData(BinaryMagic, BinaryMagicSize));
+}
+
+
+//============================================================================
+bool internal::readBinaryCount(QDataStream& s, int& Count)
+{
+	qint32 Value;
+	s >> Value;
+	if (s.status() != QDataStream::Ok || Value < 0
+	 || (!s.device()->isSequential() && Value > s.device()->bytesAvailable()))
+	{
+		return false;
+	}
+
+	Count = Value;
+	return true;
+}
+
+
+//============================================================================
+bool internal::readDockWidgetsBinary(QDataStream& s, QVector<DockWidgetState>& DockWidgets)
+{
+	int Count;
+	if (!internal::readBinaryCount(s, Count))
+	{
+		return false;
+	}
+
+	DockWidgets.reserve(qMin(Count, MaxPreallocatedCount));
+	for (int i = 0; i < Count; ++i)
+	{
+		DockWidgetState DockWidget;
+		qint32 Size;
+		s >> DockWidget.Name >> DockWidget.Closed >> Size;
+		DockWidget.Size = Size;
+		if (DockWidget.Name.isEmpty())
+		{
+			return false;
+		}
+		DockWidgets.append(DockWidget);
+	}
+
+	return s.status() == QDataStream::Ok;
+}
+
+
+//============================================================================
+static bool readContainerBinary(QDataStream& s, DockContainerState& Container)
+{
+	s >> Container.Floating >> Container.Geometry;
+	if (Container.Floating && Container.Geometry.isEmpty())
+	{
+		return false;
+	}
+
+	int NodeCount;
+	if (!internal::readBinaryCount(s, NodeCount))
+	{
+		return false;
+	}
+
+	Container.Nodes.reserve(qMin(NodeCount, MaxPreallocatedCount));
+	for (int n = 0; n < NodeCount; ++n)
+	{
+		DockLayoutNode Node;
+		quint8 Type;
+		s >> Type;
+		if (Type == DockLayoutNode::SplitterNode)
+		{
+			quint8 Orientation;
+			qint32 ChildCount;
+			int SizeCount;
+			s >> Orientation >> ChildCount;
+			if (!internal::readBinaryCount(s, SizeCount)
+			 || (Orientation != Qt::Horizontal && Orientation != Qt::Vertical)
+			 || ChildCount != SizeCount)
+			{
+				return false;
+			}
+
+			Node.Type = DockLayoutNode::SplitterNode;
+			Node.Orientation = static_cast<Qt::Orientation>(Orientation);
+			Node.ChildCount = ChildCount;
+			for (int i = 0; i < SizeCount && s.status() == QDataStream::Ok; ++i)
+			{
+				qint32 Size;
+				s >> Size;
+				Node.Sizes.append(Size);
+			}
+		}
+		else if (Type == DockLayoutNode::AreaNode)
+		{
+			qint32 AllowedAreas;
+			qint32 Flags;
+			Node.Type = DockLayoutNode::AreaNode;
+			s >> Node.Area.CurrentDockWidget >> AllowedAreas >> Flags;
+			Node.Area.AllowedAreas = AllowedAreas;
+			Node.Area.Flags = Flags;
+			if (!internal::readDockWidgetsBinary(s, Node.Area.DockWidgets))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+		Container.Nodes.append(Node);
+	}
+
+	int SideBarCount;
+	if (!internal::readBinaryCount(s, SideBarCount))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < SideBarCount; ++i)
+	{
+		AutoHideSideBarState SideBar;
+		qint32 Location;
+		s >> Location;
+		SideBar.Location = static_cast<SideBarLocation>(Location);
+		if (!internal::readDockWidgetsBinary(s, SideBar.DockWidgets))
+		{
+			return false;
+		}
+		Container.SideBars.append(SideBar);
+	}
+
+	return s.status() == QDataStream::Ok;
+}
+
+
+//============================================================================
+bool DockingState::fromBinary(const QByteArray& Data, DockingState& State)
+{
+	QBuffer Buffer;
+	Buffer.setData(Data);
+	Buffer.open(QIODevice::ReadOnly);
+	return fromBinary(&Buffer, State);
+}
+
+
+//============================================================================
+bool DockingState::fromBinary(QIODevice* Device, DockingState& State)
+{
+	QDataStream s(Device);
+	s.setVersion(BinaryStreamVersion);
+	char Magic[BinaryMagicSize];
+	if (s.readRawData(Magic, BinaryMagicSize) != BinaryMagicSize
+	 || !isBinary(QByteArray::fromRawData(Magic, BinaryMagicSize)))
+	{
+		return false;
+	}
+
+	quint32 Version;
+	s >> Version;
+	if (s.status() != QDataStream::Ok || Version < BinaryVersion1
+	 || Version > CurrentBinaryVersion)
+	{
+		return false;
+	}
+
+	// The binary format always stores the splitter orientation of the
+	// current file version
+	State.FileVersion = CurrentVersion;
+	qint32 UserVersion;
+	s >> State.HasUserVersion >> UserVersion >> State.CentralWidget;
+	State.UserVersion = UserVersion;
+	int ContainerCount;
+	if (!internal::readBinaryCount(s, ContainerCount))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < ContainerCount; ++i)
+	{
+		DockContainerState Container;
+		if (!readContainerBinary(s, Container))
+		{
+			return false;
+		}
+		State.Containers.append(Container);
+	}
+
+	// The state is always the complete content of the data, so any trailing
+	// data indicates corrupted data
+	char Byte;
+	if (s.readRawData(&Byte, 1) != 0)
+	{
+		return false;
+	}
+
+	return State.isValid();
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockingState.cpp
@@ -0,0 +1,228 @@
+#ifndef DockingStateH
+#define DockingStateH
+//============================================================================
+/// \file   DockingState.h
+/// \date   16.10.2026
+/// \brief  Declaration of the plain data layout description of the docking
+///         state
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "ads_globals.h"
+
+QT_FORWARD_DECLARE_CLASS(QXmlStreamWriter)
+QT_FORWARD_DECLARE_CLASS(QDataStream)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+namespace ads
+{
+/**
+ * State of a single dock widget in a dock area or in an auto hide side bar
+ */
+struct ADS_EXPORT DockWidgetState
+{
+	QString Name;
+	bool Closed = false;
+	int Size = 0; ///< size of the auto hide container - only used for side bars
+
+	/**
+	 * Writes the Widget element without the auto hide Size attribute
+	 */
+	void writeXml(QXmlStreamWriter& Stream) const;
+};
+
+
+/**
+ * State of a dock area with all its dock widgets
+ */
+struct ADS_EXPORT DockAreaState
+{
+	QString CurrentDockWidget;
+	int AllowedAreas = AllDockAreas;
+	int Flags = 0;
+	QVector<DockWidgetState> DockWidgets;
+
+	/**
+	 * Writes the Area element with all its dock widgets
+	 */
+	void writeXml(QXmlStreamWriter& Stream) const;
+};
+
+
+/**
+ * A node of the splitter tree of a dock container.
+ * The nodes of a container are stored in pre-order. A splitter node is
+ * followed by its ChildCount direct child nodes (and their children).
+ */
+struct ADS_EXPORT DockLayoutNode
+{
+	enum eType
+	{
+		SplitterNode,
+		AreaNode
+	};
+
+	eType Type = AreaNode;
+	Qt::Orientation Orientation = Qt::Horizontal; ///< splitter nodes only
+	int ChildCount = 0; ///< splitter nodes only
+	QList<int> Sizes; ///< splitter nodes only
+	DockAreaState Area; ///< area nodes only
+};
+
+
+/**
+ * State of an auto hide side bar
+ */
+struct ADS_EXPORT AutoHideSideBarState
+{
+	SideBarLocation Location = SideBarNone;
+	QVector<DockWidgetState> DockWidgets;
+
+	/**
+	 * Writes the SideBar element with all its auto hide widgets
+	 */
+	void writeXml(QXmlStreamWriter& Stream) const;
+};
+
+
+/**
+ * State of a dock container - i.e. the dock manager or a floating widget
+ */
+struct ADS_EXPORT DockContainerState
+{
+	bool Floating = false;
+	QByteArray Geometry; ///< floating widget geometry - only for floating containers
+	QVector<DockLayoutNode> Nodes; ///< root splitter tree in pre-order
+	QVector<AutoHideSideBarState> SideBars;
+
+	/**
+	 * Writes the Container element with the complete splitter tree and
+	 * all side bars
+	 */
+	void writeXml(QXmlStreamWriter& Stream) const;
+
+	/**
+	 * Returns true, if Nodes is empty or describes exactly one complete
+	 * splitter tree
+	 */
+	bool hasValidLayout() const;
+};
+
+
+/**
+ * Plain data description of the complete docking state of a dock manager.
+ * The state does not reference any widgets, so it can be created and
+ * validated without modifying the dock manager - even in a worker thread
+ * via CDockManager::parseState().
+ */
+struct ADS_EXPORT DockingState
+{
+	/**
+	 * Internal file version in case the structure changes internally
+	 */
+	enum eFileVersion
+	{
+		InitialVersion = 0,      //!< InitialVersion
+		Version1 = 1,            //!< Version1
+		CurrentVersion = Version1//!< CurrentVersion
+	};
+
+	/**
+	 * Version of the binary format written by toBinary()
+	 */
+	enum eBinaryVersion
+	{
+		BinaryVersion1 = 1,
+		CurrentBinaryVersion = BinaryVersion1
+	};
+
+	int FileVersion = CurrentVersion;
+	bool HasUserVersion = false;
+	int UserVersion = 0;
+	QString CentralWidget;
+	QVector<DockContainerState> Containers;
+
+	/**
+	 * Returns true, if the layout trees of all containers are valid.
+	 * The restore functions rely on valid layout trees, so a state is only
+	 * returned as successfully parsed, if this function returns true.
+	 */
+	bool isValid() const;
+
+	/**
+	 * Returns the state as XML document - this is the format that has always
+	 * been written by CDockManager::saveState().
+	 */
+	QByteArray toXml(bool AutoFormatting) const;
+
+	/**
+	 * Writes the XML document directly into the given device.
+	 * Returns false, if writing failed.
+	 */
+	bool writeXml(QIODevice* Device, bool AutoFormatting) const;
+
+	/**
+	 * Returns the state in the compact binary format. The binary data starts
+	 * with a magic header and a format version, so it can be told apart from
+	 * XML and compressed data via isBinary()
+	 */
+	QByteArray toBinary() const;
+
+	/**
+	 * Writes the binary format directly into the given device.
+	 * Returns false, if writing failed.
+	 */
+	bool writeBinary(QIODevice* Device) const;
+
+	/**
+	 * Returns true, if Data starts with the binary format header
+	 */
+	static bool isBinary(const QByteArray& Data);
+
+	/**
+	 * Parses the binary Data created by toBinary() into State. Returns false,
+	 * if the data is not a valid binary state - i.e. if the data is truncated,
+	 * if it contains trailing data or if the layout trees are invalid. Like
+	 * CDockingStateReader::readState() this function does not modify
+	 * anything except State.
+	 */
+	static bool fromBinary(const QByteArray& Data, DockingState& State);
+
+	/**
+	 * Reads the binary state from the given device. The data is decoded
+	 * while it is read, so it is never held completely in memory.
+	 */
+	static bool fromBinary(QIODevice* Device, DockingState& State);
+};
+
+
+namespace internal
+{
+/**
+ * Writes the given dock widget states in the binary format
+ */
+void writeDockWidgetsBinary(QDataStream& s, const QVector<DockWidgetState>& DockWidgets);
+
+/**
+ * Reads dock widget states written by writeDockWidgetsBinary()
+ */
+bool readDockWidgetsBinary(QDataStream& s, QVector<DockWidgetState>& DockWidgets);
+
+/**
+ * Reads a list count of the binary format and checks, that the stream is
+ * still valid and that the count is plausible for the remaining data -
+ * this prevents huge allocations for corrupted data
+ */
+bool readBinaryCount(QDataStream& s, int& Count);
+} // namespace internal
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockingStateH
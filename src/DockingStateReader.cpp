@@ -10,8 +10,242 @@
 //============================================================================
 #include "DockingStateReader.h"
 
+#include <QTextStream>
+
 namespace ads
 {
+/**
+ * Reads the dock widget entries of a dock area or side bar element.
+ * If ReadSize is true, the Size attribute of auto hide widgets is required
+ */
+static bool readDockWidgets(CDockingStateReader& s, QVector<DockWidgetState>& DockWidgets,
+	bool ReadSize)
+{
+	while (s.readNextStartElement())
+	{
+		if (s.name() != QLatin1String("Widget"))
+		{
+			s.skipCurrentElement();
+			continue;
+		}
+
+		DockWidgetState DockWidget;
+		DockWidget.Name = s.attributes().value("Name").toString();
+		if (DockWidget.Name.isEmpty())
+		{
+			return false;
+		}
+
+		bool Ok;
+		DockWidget.Closed = s.attributes().value("Closed").toInt(&Ok);
+		if (!Ok)
+		{
+			return false;
+		}
+
+		if (ReadSize)
+		{
+			DockWidget.Size = s.attributes().value("Size").toInt(&Ok);
+			if (!Ok)
+			{
+				return false;
+			}
+		}
+
+		s.skipCurrentElement();
+		DockWidgets.append(DockWidget);
+	}
+
+	return true;
+}
+
+
+/**
+ * Reads a dock area element
+ */
+static bool readDockArea(CDockingStateReader& s, DockAreaState& Area)
+{
+	Area.CurrentDockWidget = s.attributes().value("Current").toString();
+	const auto AllowedAreasAttribute = s.attributes().value("AllowedAreas");
+	if (!AllowedAreasAttribute.isEmpty())
+	{
+		Area.AllowedAreas = AllowedAreasAttribute.toInt(nullptr, 16);
+	}
+
+	const auto FlagsAttribute = s.attributes().value("Flags");
+	if (!FlagsAttribute.isEmpty())
+	{
+		Area.Flags = FlagsAttribute.toInt(nullptr, 16);
+	}
+
+	return readDockWidgets(s, Area.DockWidgets, false);
+}
+
+
+/**
+ * Reads a splitter element and all its child elements and appends the
+ * created nodes in pre-order to the given node list
+ */
+static bool readSplitter(CDockingStateReader& s, QVector<DockLayoutNode>& Nodes)
+{
+	QString OrientationStr = s.attributes().value("Orientation").toString();
+
+	// Check if the orientation string is right
+	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
+	{
+		return false;
+	}
+
+	// The "|" shall indicate a vertical splitter handle which in turn means
+	// a Horizontal orientation of the splitter layout.
+	bool HorizontalSplitter = OrientationStr.startsWith("|");
+	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
+	// but this is wrong, because only the splitter handle is vertical, the
+	// layout of the splitter is a horizontal layout. We fix this here
+	if (s.fileVersion() == 0)
+	{
+		HorizontalSplitter = !HorizontalSplitter;
+	}
+
+	bool Ok;
+	int WidgetCount = s.attributes().value("Count").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	int SplitterIndex = Nodes.count();
+	DockLayoutNode Splitter;
+	Splitter.Type = DockLayoutNode::SplitterNode;
+	Splitter.Orientation = HorizontalSplitter ? Qt::Horizontal : Qt::Vertical;
+	Nodes.append(Splitter);
+
+	int ChildCount = 0;
+	QList<int> Sizes;
+	while (s.readNextStartElement())
+	{
+		if (s.name() == QLatin1String("Splitter"))
+		{
+			if (!readSplitter(s, Nodes))
+			{
+				return false;
+			}
+			ChildCount++;
+		}
+		else if (s.name() == QLatin1String("Area"))
+		{
+			DockLayoutNode Area;
+			Area.Type = DockLayoutNode::AreaNode;
+			if (!readDockArea(s, Area.Area))
+			{
+				return false;
+			}
+			Nodes.append(Area);
+			ChildCount++;
+		}
+		else if (s.name() == QLatin1String("Sizes"))
+		{
+			QString sSizes = s.readElementText().trimmed();
+			QTextStream TextStream(&sSizes);
+			while (!TextStream.atEnd())
+			{
+				int value = 0;
+				TextStream >> value;
+				Sizes.append(value);
+			}
+		}
+		else
+		{
+			s.skipCurrentElement();
+		}
+	}
+
+	if (Sizes.count() != WidgetCount)
+	{
+		return false;
+	}
+
+	Nodes[SplitterIndex].ChildCount = ChildCount;
+	Nodes[SplitterIndex].Sizes = Sizes;
+	return true;
+}
+
+
+/**
+ * Reads an auto hide side bar element
+ */
+static bool readSideBar(CDockingStateReader& s, AutoHideSideBarState& SideBar)
+{
+	bool Ok;
+	SideBar.Location = (ads::SideBarLocation)s.attributes().value("Area").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	return readDockWidgets(s, SideBar.DockWidgets, true);
+}
+
+
+/**
+ * Reads a container element
+ */
+static bool readContainer(CDockingStateReader& s, DockContainerState& Container)
+{
+	Container.Floating = s.attributes().value("Floating").toInt();
+	if (Container.Floating)
+	{
+		if (!s.readNextStartElement() || s.name() != QLatin1String("Geometry"))
+		{
+			return false;
+		}
+
+		QByteArray GeometryString = s.readElementText(CDockingStateReader::ErrorOnUnexpectedElement).toLocal8Bit();
+		Container.Geometry = QByteArray::fromHex(GeometryString);
+		if (Container.Geometry.isEmpty())
+		{
+			return false;
+		}
+	}
+
+	while (s.readNextStartElement())
+	{
+		if (s.name() == QLatin1String("Splitter"))
+		{
+			Container.Nodes.clear();
+			if (!readSplitter(s, Container.Nodes))
+			{
+				return false;
+			}
+		}
+		else if (s.name() == QLatin1String("Area"))
+		{
+			DockLayoutNode Area;
+			Area.Type = DockLayoutNode::AreaNode;
+			if (!readDockArea(s, Area.Area))
+			{
+				return false;
+			}
+			Container.Nodes = {Area};
+		}
+		else if (s.name() == QLatin1String("SideBar"))
+		{
+			AutoHideSideBarState SideBar;
+			if (!readSideBar(s, SideBar))
+			{
+				return false;
+			}
+			Container.SideBars.append(SideBar);
+		}
+		else
+		{
+			s.skipCurrentElement();
+		}
+	}
+
+	return true;
+}
+
 
 //============================================================================
 void CDockingStateReader::setFileVersion(int FileVersion)
@@ -24,6 +258,59 @@ int CDockingStateReader::fileVersion() const
 {
 	return m_FileVersion;
 }
+
+
+//============================================================================
+bool CDockingStateReader::readState(DockingState& State)
+{
+	readNextStartElement();
+	if (name() != QLatin1String("QtAdvancedDockingSystem"))
+	{
+		return false;
+	}
+
+	bool Ok;
+	int v = attributes().value("Version").toInt(&Ok);
+	if (!Ok || v > DockingState::CurrentVersion)
+	{
+		return false;
+	}
+	setFileVersion(v);
+	State.FileVersion = v;
+
+	// Older files do not support UserVersion but we still want to load them so
+	// we first test if the attribute exists
+	if (!attributes().value("UserVersion").isEmpty())
+	{
+		State.UserVersion = attributes().value("UserVersion").toInt(&Ok);
+		if (!Ok)
+		{
+			return false;
+		}
+		State.HasUserVersion = true;
+	}
+
+	State.CentralWidget = attributes().value("CentralWidget").toString();
+	while (readNextStartElement())
+	{
+		if (name() != QLatin1String("Container"))
+		{
+			skipCurrentElement();
+			continue;
+		}
+
+		DockContainerState Container;
+		if (!readContainer(*this, Container))
+		{
+			return false;
+		}
+		State.Containers.append(Container);
+	}
+
+	// readNextStartElement() also stops on a parse error, so truncated or
+	// malformed data after the last container must be rejected here
+	return !hasError();
+}
 } // namespace ads
 
 //---------------------------------------------------------------------------
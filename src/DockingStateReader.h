@@ -12,6 +12,8 @@
 //============================================================================
 #include <QXmlStreamReader>
 
+#include "DockingState.h"
+
 namespace ads
 {
 
@@ -35,6 +37,15 @@ public:
 	 * Returns the file version set via setFileVersion
 	 */
 	int fileVersion() const;
+
+	/**
+	 * Parses the complete XML document into the given layout State.
+	 * The function checks the structure of the document and returns false,
+	 * if the data is not a valid docking system state. Nothing except the
+	 * given State is modified, so it is safe to call this function from
+	 * any thread.
+	 */
+	bool readState(DockingState& State);
 };
 
 } // namespace ads
@@ -33,6 +33,19 @@
 
 namespace ads
 {
+/**
+ * Returns the horizontal advance of the given text
+ */
+static int horizontalAdvance(const QFontMetrics& fm, const QString& Text)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
+	return fm.horizontalAdvance(Text);
+#else
+	return fm.width(Text);
+#endif
+}
+
+
 /**
  * Private data of public CClickableLabel
  */
@@ -42,11 +55,51 @@ struct ElidingLabelPrivate
 	Qt::TextElideMode ElideMode = Qt::ElideNone;
 	QString Text;
 	bool IsElided = false;
+	int TextWidth = -1; ///< cached width of the complete text
+	int MinimumTextWidth = -1; ///< cached width of the minimum size hint text
+	QString ElidedText; ///< result of the last elideText() call
+	int ElidedTextMinWidth = 0; ///< ElidedText is valid for available widths
+	int ElidedTextMaxWidth = -1; ///< between min and max width
 
 	ElidingLabelPrivate(CElidingLabel* _public) : _this(_public) {}
 
 	void elideText(int Width);
 
+	/**
+	 * Clears all cached text measurements. Needs to be called if the text,
+	 * the font or the elide mode changes
+	 */
+	void invalidateTextCache()
+	{
+		TextWidth = -1;
+		MinimumTextWidth = -1;
+		ElidedTextMaxWidth = -1;
+	}
+
+	/**
+	 * Returns the width of the complete text
+	 */
+	int textWidth()
+	{
+		if (TextWidth < 0)
+		{
+			TextWidth = horizontalAdvance(_this->fontMetrics(), Text);
+		}
+		return TextWidth;
+	}
+
+	/**
+	 * Returns the width of the text shown in the minimum size hint
+	 */
+	int minimumTextWidth()
+	{
+		if (MinimumTextWidth < 0)
+		{
+			MinimumTextWidth = horizontalAdvance(_this->fontMetrics(), Text.left(2) + "…");
+		}
+		return MinimumTextWidth;
+	}
+
 	/**
 	 * Convenience function to check if the
 	 */
@@ -64,12 +117,30 @@ void ElidingLabelPrivate::elideText(int Width)
 	{
 		return;
 	}
-    QFontMetrics fm = _this->fontMetrics();
-    QString  str = fm.elidedText(Text, ElideMode, Width - _this->margin() * 2 - _this->indent());
-    if (str == "…")
-    {
-    	str = Text.at(0);
-    }
+	int AvailableWidth = Width - _this->margin() * 2 - _this->indent();
+	QString str;
+	if (AvailableWidth >= textWidth())
+	{
+		str = Text;
+	}
+	else if (AvailableWidth >= ElidedTextMinWidth && AvailableWidth <= ElidedTextMaxWidth)
+	{
+		// The elided text fits and no longer text would have fit into the
+		// wider width, so it is also the result for this width
+		str = ElidedText;
+	}
+	else
+	{
+		QFontMetrics fm = _this->fontMetrics();
+		str = fm.elidedText(Text, ElideMode, AvailableWidth);
+		ElidedTextMinWidth = horizontalAdvance(fm, str);
+		ElidedTextMaxWidth = AvailableWidth;
+		if (str == "…")
+		{
+			str = Text.at(0);
+		}
+		ElidedText = str;
+	}
     bool WasElided = IsElided;
     IsElided = str != Text;
     if(IsElided != WasElided)
@@ -117,6 +188,7 @@ Qt::TextElideMode CElidingLabel::elideMode() const
 void CElidingLabel::setElideMode(Qt::TextElideMode mode)
 {
 	d->ElideMode = mode;
+	d->invalidateTextCache();
 	d->elideText(size().width());
 }
 
@@ -160,6 +232,17 @@ void CElidingLabel::resizeEvent(QResizeEvent *event)
 }
 
 
+//============================================================================
+void CElidingLabel::changeEvent(QEvent *event)
+{
+	if (event->type() == QEvent::FontChange)
+	{
+		d->invalidateTextCache();
+	}
+	Super::changeEvent(event);
+}
+
+
 //============================================================================
 QSize CElidingLabel::minimumSizeHint() const
 {
@@ -172,12 +255,7 @@ QSize CElidingLabel::minimumSizeHint() const
     {
         return QLabel::minimumSizeHint();
     }
-    const QFontMetrics  &fm = fontMetrics();
-    #if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
-        QSize size(fm.horizontalAdvance(d->Text.left(2) + "…"), fm.height());
-    #else
-        QSize size(fm.width(d->Text.left(2) + "…"), fm.height());
-    #endif
+    QSize size(d->minimumTextWidth(), fontMetrics().height());
     return size;
 }
 
@@ -194,12 +272,7 @@ QSize CElidingLabel::sizeHint() const
     {
         return QLabel::sizeHint();
     }
-    const QFontMetrics& fm = fontMetrics();
-    #if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
-        QSize size(fm.horizontalAdvance(d->Text), QLabel::sizeHint().height());
-    #else
-        QSize size(fm.width(d->Text), QLabel::sizeHint().height());
-    #endif
+    QSize size(d->textWidth(), QLabel::sizeHint().height());
 	return size;
 }
 
@@ -207,7 +280,11 @@ QSize CElidingLabel::sizeHint() const
 //============================================================================
 void CElidingLabel::setText(const QString &text)
 {
-	d->Text = text;
+	if (d->Text != text)
+	{
+		d->Text = text;
+		d->invalidateTextCache();
+	}
 	if (d->isModeElideNone())
 	{
 		Super::setText(text);
@@ -55,6 +55,11 @@ protected:
     virtual void resizeEvent( QResizeEvent *event ) override;
     virtual void mouseDoubleClickEvent( QMouseEvent *ev ) override;
 
+	/**
+	 * Clears the cached text measurements if the font changes
+	 */
+	virtual void changeEvent(QEvent *event) override;
+
 public:
     using Super = QLabel;
 
@@ -39,12 +39,14 @@
 #include <QAbstractButton>
 #include <QElapsedTimer>
 #include <QTime>
+#include <QLabel>
 
 #include "DockContainerWidget.h"
 #include "DockAreaWidget.h"
 #include "DockManager.h"
 #include "DockWidget.h"
 #include "DockOverlay.h"
+#include "DockDragSnapshot.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -374,6 +376,10 @@ struct FloatingDockContainerPrivate
 	QPoint DragStartPos;
 	bool Hiding = false;
 	bool AutoHideChildren = true;
+	QSharedPointer<CDockDragSnapshot> DragSnapshot;
+	internal::CDragMoveCoalescer DropOverlayUpdate;
+	QLabel* SnapshotLabel = nullptr;
+	bool ShowsSnapshot = false;
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
     QWidget* MouseEventHandler = nullptr;
     CFloatingWidgetTitleBar* TitleBar = nullptr;
@@ -421,6 +427,102 @@ struct FloatingDockContainerPrivate
         {
             qApp->postEvent(_this, new QEvent((QEvent::Type)internal::FloatingWidgetDragStartEvent));
         }
+        else
+        {
+            DropOverlayUpdate.cancel();
+            releaseDragSnapshot();
+            showLiveContent();
+        }
+	}
+
+	/**
+	 * Replaces the live content by a snapshot pixmap while the floating
+	 * widget is dragged, if the FloatingWidgetDragShowsSnapshot flag is set.
+	 * Updates of the dock container are disabled, so that the live content
+	 * is not repainted while the window moves.
+	 */
+	void showContentSnapshot()
+	{
+		if (ShowsSnapshot || !_this->isVisible()
+		 || !testConfigFlag(CDockManager::FloatingWidgetDragShowsSnapshot))
+		{
+			return;
+		}
+
+		if (!SnapshotLabel)
+		{
+			SnapshotLabel = new QLabel(_this);
+			SnapshotLabel->setObjectName("floatingWidgetSnapshot");
+		}
+		SnapshotLabel->setPixmap(DockContainer->grab());
+		SnapshotLabel->setGeometry(QRect(DockContainer->mapTo(_this, QPoint(0, 0)),
+			DockContainer->size()));
+		SnapshotLabel->raise();
+		SnapshotLabel->show();
+		DockContainer->setUpdatesEnabled(false);
+		ShowsSnapshot = true;
+	}
+
+	/**
+	 * Swaps the snapshot back to the live content
+	 */
+	void showLiveContent()
+	{
+		if (!ShowsSnapshot)
+		{
+			return;
+		}
+
+		ShowsSnapshot = false;
+		DockContainer->setUpdatesEnabled(true);
+		SnapshotLabel->hide();
+		SnapshotLabel->clear();
+	}
+
+	/**
+	 * Requests an update of the drop overlays for the current cursor
+	 * position - see internal::CDragMoveCoalescer
+	 */
+	void requestDropOverlayUpdate()
+	{
+		// The snapshot is taken on the first move after the widget has
+		// been shown and laid out
+		showContentSnapshot();
+		DropOverlayUpdate.request();
+	}
+
+	/**
+	 * Returns the drop target snapshot of the running drag operation.
+	 * The snapshot is captured on the first mouse move and captured again,
+	 * if the layout changed in between
+	 */
+	const CDockDragSnapshot* dragSnapshot()
+	{
+		if (!DragSnapshot || DragSnapshot->isOutdated())
+		{
+			DragSnapshot.reset(new CDockDragSnapshot());
+			DragSnapshot->capture(DockManager, DockContainer);
+		}
+		return DragSnapshot.data();
+	}
+
+	/**
+	 * Releases the drag snapshot and removes it from the overlays, so that
+	 * the overlays use the real cursor position again
+	 */
+	void releaseDragSnapshot()
+	{
+		if (!DragSnapshot)
+		{
+			return;
+		}
+
+		DragSnapshot.reset();
+		if (DockManager)
+		{
+			DockManager->containerOverlay()->setDragSnapshot(QSharedPointer<const CDockDragSnapshot>());
+			DockManager->dockAreaOverlay()->setDragSnapshot(QSharedPointer<const CDockDragSnapshot>());
+		}
 	}
 
 	void setWindowTitle(const QString &Text)
@@ -485,14 +587,26 @@ struct FloatingDockContainerPrivate
 //============================================================================
 FloatingDockContainerPrivate::FloatingDockContainerPrivate(
     CFloatingDockContainer *_public) :
-	_this(_public)
+	_this(_public),
+	DropOverlayUpdate(_public, [this]()
+	{
+		updateDropOverlays(QCursor::pos());
+#ifdef Q_OS_MACOS
+		// Like the move handling, we reset the active window to the floating
+		// widget after updating the overlays
+		_this->activateWindow();
+#endif
+	})
 {
-
 }
 
 //============================================================================
 void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 {
+	if (isState(DraggingFloatingWidget))
+	{
+		DropOverlayUpdate.flush();
+	}
 	setState(DraggingInactive);
 	if (!DropContainer)
 	{
@@ -554,33 +668,18 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
     }
 #endif
 
-	auto Containers = DockManager->dockContainers();
-	CDockContainerWidget *TopContainer = nullptr;
-	for (auto ContainerWidget : Containers)
-	{
-		if (!ContainerWidget->isVisible())
-		{
-			continue;
-		}
-
-		if (DockContainer == ContainerWidget)
-		{
-			continue;
-		}
-
-		QPoint MappedPos = ContainerWidget->mapFromGlobal(GlobalPos);
-		if (ContainerWidget->rect().contains(MappedPos))
-		{
-			if (!TopContainer || ContainerWidget->isInFrontOf(TopContainer))
-			{
-				TopContainer = ContainerWidget;
-			}
-		}
-	}
+	// The drop targets are resolved from the snapshot that has been captured
+	// when dragging started to avoid querying and mapping all widgets again
+	// for each mouse move
+	auto Snapshot = dragSnapshot();
+	auto Target = Snapshot->containerAt(GlobalPos);
+	CDockContainerWidget *TopContainer = Target ? Target->Container.data() : nullptr;
 
 	DropContainer = TopContainer;
 	auto ContainerOverlay = DockManager->containerOverlay();
 	auto DockAreaOverlay = DockManager->dockAreaOverlay();
+	ContainerOverlay->setDragSnapshot(DragSnapshot, GlobalPos);
+	DockAreaOverlay->setDragSnapshot(DragSnapshot, GlobalPos);
 
 	if (!TopContainer)
 	{
@@ -589,15 +688,16 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	int VisibleDockAreas = TopContainer->visibleDockAreaCount();
+	int VisibleDockAreas = Target->VisibleDockAreaCount;
 	DockWidgetAreas AllowedContainerAreas = (VisibleDockAreas > 1) ? OuterDockAreas : AllDockAreas;
-	auto DockArea = TopContainer->dockAreaAt(GlobalPos);
+	auto AreaTarget = Target->dockAreaAt(GlobalPos);
+	auto DockArea = AreaTarget ? AreaTarget->DockArea.data() : nullptr;
 	// If the dock container contains only one single DockArea, then we need
 	// to respect the allowed areas - only the center area is relevant here because
 	// all other allowed areas are from the container
 	if (VisibleDockAreas == 1 && DockArea)
 	{
-		AllowedContainerAreas.setFlag(CenterDockWidgetArea, DockArea->allowedAreas().testFlag(CenterDockWidgetArea));
+		AllowedContainerAreas.setFlag(CenterDockWidgetArea, AreaTarget->AllowedAreas.testFlag(CenterDockWidgetArea));
 	}
 
 	if (DockContainer->features().testFlag(CDockWidget::DockWidgetPinnable))
@@ -609,11 +709,11 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
 
 	DockWidgetArea ContainerArea = ContainerOverlay->showOverlay(TopContainer);
 	ContainerOverlay->enableDropPreview(ContainerArea != InvalidDockWidgetArea);
-	if (DockArea && DockArea->isVisible() && VisibleDockAreas > 0)
+	if (DockArea && VisibleDockAreas > 0)
 	{
 		DockAreaOverlay->enableDropPreview(true);
 		DockAreaOverlay->setAllowedAreas(
-		    (VisibleDockAreas == 1) ? NoDockWidgetArea : DockArea->allowedAreas());
+		    (VisibleDockAreas == 1) ? NoDockWidgetArea : AreaTarget->AllowedAreas);
 		DockWidgetArea Area = DockAreaOverlay->showOverlay(DockArea);
 
 		// A CenterDockWidgetArea for the dockAreaOverlay() indicates that
@@ -769,6 +869,7 @@ CFloatingDockContainer::~CFloatingDockContainer()
 	{
 		d->DockManager->removeFloatingWidget(this);
 	}
+	d->releaseDragSnapshot();
 	delete d;
 }
 
@@ -868,7 +969,7 @@ bool CFloatingDockContainer::nativeEvent(const QByteArray &eventType, void *mess
 		{
 			if (d->isState(DraggingFloatingWidget))
 			{
-				d->updateDropOverlays(QCursor::pos());
+				d->requestDropOverlayUpdate();
 			}
 		}
 		break;
@@ -1053,7 +1154,7 @@ void CFloatingDockContainer::moveFloating()
 		break;
 
 	case DraggingFloatingWidget:
-		d->updateDropOverlays(QCursor::pos());
+		d->requestDropOverlayUpdate();
 #ifdef Q_OS_MACOS
 		// In OSX when hiding the DockAreaOverlay the application would set
 		// the main window as the active window for some reason. This fixes
@@ -1136,13 +1237,9 @@ void CFloatingDockContainer::onDockAreaCurrentChanged(int Index)
 }
 
 //============================================================================
-bool CFloatingDockContainer::restoreState(CDockingStateReader &Stream,
-    bool Testing)
+void CFloatingDockContainer::restoreState(const DockContainerState& State)
 {
-	if (!d->DockContainer->restoreState(Stream, Testing))
-	{
-		return false;
-	}
+	d->DockContainer->restoreState(State);
 	onDockAreasAddedOrRemoved();
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
 	if(d->TitleBar)
@@ -1150,7 +1247,6 @@ bool CFloatingDockContainer::restoreState(CDockingStateReader &Stream,
 		d->TitleBar->setMaximizedIcon(windowState() == Qt::WindowMaximized);
 	}
 #endif
-	return true;
 }
 
 
@@ -1297,7 +1393,7 @@ void CFloatingDockContainer::moveEvent(QMoveEvent *event)
 		break;
 
 	case DraggingFloatingWidget:
-		d->updateDropOverlays(QCursor::pos());
+		d->requestDropOverlayUpdate();
 		// In OSX when hiding the DockAreaOverlay the application would set
 		// the main window as the active window for some reason. This fixes
 		// that by resetting the active window to the floating widget after
@@ -1390,7 +1486,7 @@ void CFloatingDockContainer::moveEvent(QMoveEvent *event)
     if (!d->IsResizing && event->spontaneous() && d->MousePressed)
 	{
         d->setState(DraggingFloatingWidget);
-		d->updateDropOverlays(QCursor::pos());
+		d->requestDropOverlayUpdate();
 	}
 	d->IsResizing = false;
 }
@@ -41,8 +41,6 @@
 #define tFloatingWidgetBase QWidget
 #endif
 
-class CDockingStateReader;
-
 namespace ads
 {
 struct FloatingDockContainerPrivate;
@@ -58,7 +56,7 @@ struct DockWidgetTabPrivate;
 class CDockAreaTitleBar;
 struct DockAreaTitleBarPrivate;
 class CFloatingWidgetTitleBar;
-class CDockingStateReader;
+struct DockContainerState;
 
 /**
  * Pure virtual interface for floating widgets.
@@ -169,12 +167,9 @@ protected:
 	void moveFloating() override;
 
 	/**
-	 * Restores the state from given stream.
-	 * If Testing is true, the function only parses the data from the given
-	 * stream but does not restore anything. You can use this check for
-	 * faulty files before you start restoring the state
+	 * Restores the state from the given, already validated, container state
 	 */
-	bool restoreState(CDockingStateReader& Stream, bool Testing);
+	void restoreState(const DockContainerState& State);
 
 	/**
 	 * Call this function to update the window title
@@ -16,17 +16,25 @@
 #include <QApplication>
 #include <QPainter>
 #include <QKeyEvent>
+#include <QTimer>
 
 #include "DockWidget.h"
 #include "DockAreaWidget.h"
 #include "DockManager.h"
 #include "DockContainerWidget.h"
 #include "DockOverlay.h"
+#include "DockDragSnapshot.h"
 #include "AutoHideDockContainer.h"
 #include "ads_globals.h"
 
 namespace ads
 {
+/**
+ * Maximum width or height of the content preview pixmap. Larger content is
+ * captured at a reduced resolution and scaled up when painted.
+ */
+static const int MaxContentPixmapExtent = 1024;
+
 
 /**
  * Private data class (pimpl)
@@ -43,7 +51,13 @@ struct FloatingDragPreviewPrivate
 	qreal WindowOpacity;
 	bool Hidden = false;
 	QPixmap ContentPreviewPixmap;
+	QSize ContentPixmapSize; ///< size of the content the preview pixmap is painted with
+	bool ContentPixmapPending = false;
 	bool Canceled = false;
+	bool Reusable = false; ///< true for the preview that is kept alive by the dock manager
+	bool Dragging = false;
+	QSharedPointer<CDockDragSnapshot> DragSnapshot;
+	internal::CDragMoveCoalescer DropOverlayUpdate;
 
 
 	/**
@@ -52,22 +66,81 @@ struct FloatingDragPreviewPrivate
 	FloatingDragPreviewPrivate(CFloatingDragPreview *_public);
 	void updateDropOverlays(const QPoint &GlobalPos);
 
+	/**
+	 * Assigns the content that should get undocked and resets the state
+	 * of the previous drag operation
+	 */
+	void setContent(QWidget* Widget);
+
+	/**
+	 * Requests the capture of the content preview pixmap. The pixmap is
+	 * captured in the next event loop cycle, so that the drag preview is
+	 * shown immediately. Until the pixmap is ready, only the preview frame
+	 * is painted.
+	 */
+	void requestContentPixmap();
+
+	/**
+	 * Captures the pending content preview pixmap at reduced resolution
+	 */
+	void captureContentPixmap();
+
+	/**
+	 * Removes the application event filter and releases the content of a
+	 * reusable preview if dragging finished or has been canceled
+	 */
+	void endDragging();
+
 	void setHidden(bool Value)
 	{
 		Hidden = Value;
 		_this->update();
 	}
 
+	/**
+	 * Returns the drop target snapshot of the running drag operation.
+	 * The snapshot is captured on the first mouse move and captured again,
+	 * if the layout changed in between
+	 */
+	const CDockDragSnapshot* dragSnapshot()
+	{
+		if (!DragSnapshot || DragSnapshot->isOutdated())
+		{
+			DragSnapshot.reset(new CDockDragSnapshot());
+			DragSnapshot->capture(DockManager);
+		}
+		return DragSnapshot.data();
+	}
+
+	/**
+	 * Releases the drag snapshot and removes it from the overlays, so that
+	 * the overlays use the real cursor position again
+	 */
+	void releaseDragSnapshot()
+	{
+		if (!DragSnapshot)
+		{
+			return;
+		}
+
+		DragSnapshot.reset();
+		DockManager->containerOverlay()->setDragSnapshot(QSharedPointer<const CDockDragSnapshot>());
+		DockManager->dockAreaOverlay()->setDragSnapshot(QSharedPointer<const CDockDragSnapshot>());
+	}
+
 	/**
 	 * Cancel dragging and emit the draggingCanceled event
 	 */
 	void cancelDragging()
 	{
 		Canceled = true;
+		DropOverlayUpdate.cancel();
+		releaseDragSnapshot();
 		Q_EMIT _this->draggingCanceled();
 		DockManager->containerOverlay()->hideOverlay();
 		DockManager->dockAreaOverlay()->hideOverlay();
 		_this->close();
+		endDragging();
 	}
 
 	/**
@@ -123,28 +196,18 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	auto Containers = DockManager->dockContainers();
-	CDockContainerWidget *TopContainer = nullptr;
-	for (auto ContainerWidget : Containers)
-	{
-		if (!ContainerWidget->isVisible())
-		{
-			continue;
-		}
-
-		QPoint MappedPos = ContainerWidget->mapFromGlobal(GlobalPos);
-		if (ContainerWidget->rect().contains(MappedPos))
-		{
-			if (!TopContainer || ContainerWidget->isInFrontOf(TopContainer))
-			{
-				TopContainer = ContainerWidget;
-			}
-		}
-	}
+	// The drop targets are resolved from the snapshot that has been captured
+	// when dragging started to avoid querying and mapping all widgets again
+	// for each mouse move
+	auto Snapshot = dragSnapshot();
+	auto Target = Snapshot->containerAt(GlobalPos);
+	CDockContainerWidget *TopContainer = Target ? Target->Container.data() : nullptr;
 
 	DropContainer = TopContainer;
 	auto ContainerOverlay = DockManager->containerOverlay();
 	auto DockAreaOverlay = DockManager->dockAreaOverlay();
+	ContainerOverlay->setDragSnapshot(DragSnapshot, GlobalPos);
+	DockAreaOverlay->setDragSnapshot(DragSnapshot, GlobalPos);
 
 	if (!TopContainer)
 	{
@@ -160,7 +223,7 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 	auto DockDropArea = DockAreaOverlay->dropAreaUnderCursor();
 	auto ContainerDropArea = ContainerOverlay->dropAreaUnderCursor();
 
-	int VisibleDockAreas = TopContainer->visibleDockAreaCount();
+	int VisibleDockAreas = Target->VisibleDockAreaCount;
 
 	// Include the overlay widget we're dragging as a visible widget
 	auto dockAreaWidget = qobject_cast<CDockAreaWidget*>(Content);
@@ -171,13 +234,14 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 
 	DockWidgetAreas AllowedContainerAreas = (VisibleDockAreas > 1) ? OuterDockAreas : AllDockAreas;
 	//ContainerOverlay->enableDropPreview(ContainerDropArea != InvalidDockWidgetArea);
-	auto DockArea = TopContainer->dockAreaAt(GlobalPos);
+	auto AreaTarget = Target->dockAreaAt(GlobalPos);
+	auto DockArea = AreaTarget ? AreaTarget->DockArea.data() : nullptr;
 	// If the dock container contains only one single DockArea, then we need
 	// to respect the allowed areas - only the center area is relevant here because
 	// all other allowed areas are from the container
 	if (VisibleDockAreas == 1 && DockArea)
 	{
-		AllowedContainerAreas.setFlag(CenterDockWidgetArea, DockArea->allowedAreas().testFlag(CenterDockWidgetArea));
+		AllowedContainerAreas.setFlag(CenterDockWidgetArea, AreaTarget->AllowedAreas.testFlag(CenterDockWidgetArea));
 	}
 
 	if (isContentPinnable())
@@ -186,10 +250,10 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 	}
 	ContainerOverlay->setAllowedAreas(AllowedContainerAreas);
 	ContainerOverlay->enableDropPreview(ContainerDropArea != InvalidDockWidgetArea);
-	if (DockArea && DockArea->isVisible() && VisibleDockAreas >= 0 && DockArea != ContentSourceArea)
+	if (DockArea && VisibleDockAreas >= 0 && DockArea != ContentSourceArea)
 	{
 		DockAreaOverlay->enableDropPreview(true);
-		DockAreaOverlay->setAllowedAreas( (VisibleDockAreas == 1) ? NoDockWidgetArea : DockArea->allowedAreas());
+		DockAreaOverlay->setAllowedAreas( (VisibleDockAreas == 1) ? NoDockWidgetArea : AreaTarget->AllowedAreas);
 		DockWidgetArea Area = DockAreaOverlay->showOverlay(DockArea);
 
 		// A CenterDockWidgetArea for the dockAreaOverlay() indicates that
@@ -235,10 +299,107 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 
 
 //============================================================================
-FloatingDragPreviewPrivate::FloatingDragPreviewPrivate(CFloatingDragPreview *_public) :
-	_this(_public)
+void FloatingDragPreviewPrivate::setContent(QWidget* Widget)
 {
+	Content = Widget;
+	ContentFeatures = contentFeatures();
+	ContentSourceArea = nullptr;
+	DropContainer = nullptr;
+	Canceled = false;
+	Hidden = false;
+
+	auto DockWidget = qobject_cast<CDockWidget*>(Content);
+	if (DockWidget)
+	{
+		DockManager = DockWidget->dockManager();
+		if (DockWidget->dockAreaWidget()->openDockWidgetsCount() == 1)
+		{
+			ContentSourceArea = DockWidget->dockAreaWidget();
+		}
+		_this->setWindowTitle(DockWidget->windowTitle());
+	}
 
+	auto DockArea = qobject_cast<CDockAreaWidget*>(Content);
+	if (DockArea)
+	{
+		DockManager = DockArea->dockManager();
+		ContentSourceArea = DockArea;
+		_this->setWindowTitle(DockArea->currentDockWidget()->windowTitle());
+	}
+
+	requestContentPixmap();
+}
+
+
+//============================================================================
+void FloatingDragPreviewPrivate::requestContentPixmap()
+{
+	ContentPreviewPixmap = QPixmap();
+	ContentPixmapPending = false;
+	if (!CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	{
+		return;
+	}
+
+	ContentPixmapPending = true;
+	QTimer::singleShot(0, _this, [this]()
+	{
+		captureContentPixmap();
+	});
+}
+
+
+//============================================================================
+void FloatingDragPreviewPrivate::captureContentPixmap()
+{
+	if (!ContentPixmapPending || !Content)
+	{
+		return;
+	}
+
+	// Create a static image of the widget that should get undocked
+	// This is like some kind preview image like it is uses in drag and drop
+	// operations. Large content is rendered at a reduced resolution because
+	// the preview is painted semi transparent anyway
+	ContentPixmapPending = false;
+	ContentPixmapSize = Content->size();
+	int Extent = qMax(ContentPixmapSize.width(), ContentPixmapSize.height());
+	qreal Scale = (Extent > MaxContentPixmapExtent)
+		? qreal(MaxContentPixmapExtent) / Extent : 1.0;
+	QPixmap Pixmap((QSizeF(ContentPixmapSize) * Scale).toSize());
+	Pixmap.fill(Qt::transparent);
+	QPainter Painter(&Pixmap);
+	Painter.scale(Scale, Scale);
+	Content->render(&Painter);
+	Painter.end();
+	ContentPreviewPixmap = Pixmap;
+	_this->update();
+}
+
+
+//============================================================================
+void FloatingDragPreviewPrivate::endDragging()
+{
+	Dragging = false;
+	ContentPixmapPending = false;
+	qApp->removeEventFilter(_this);
+	if (!Reusable)
+	{
+		return;
+	}
+
+	Content = nullptr;
+	ContentSourceArea = nullptr;
+	DropContainer = nullptr;
+	ContentPreviewPixmap = QPixmap();
+}
+
+
+//============================================================================
+FloatingDragPreviewPrivate::FloatingDragPreviewPrivate(CFloatingDragPreview *_public) :
+	_this(_public),
+	DropOverlayUpdate(_public, [this](){ updateDropOverlays(QCursor::pos()); })
+{
 }
 
 
@@ -280,9 +441,9 @@ CFloatingDragPreview::CFloatingDragPreview(QWidget* Content, QWidget* parent) :
 	QWidget(parent),
 	d(new FloatingDragPreviewPrivate(this))
 {
-	d->Content = Content;
-	d->ContentFeatures = d->contentFeatures();
-	setAttribute(Qt::WA_DeleteOnClose);
+	d->Reusable = !Content;
+	d->DockManager = qobject_cast<CDockManager*>(parent);
+	setAttribute(Qt::WA_DeleteOnClose, !d->Reusable);
 	if (CDockManager::testConfigFlag(CDockManager::DragPreviewHasWindowFrame))
 	{
 		setWindowFlags(
@@ -301,21 +462,13 @@ CFloatingDragPreview::CFloatingDragPreview(QWidget* Content, QWidget* parent) :
     setWindowFlags(Flags);
 #endif
 
-	// Create a static image of the widget that should get undocked
-	// This is like some kind preview image like it is uses in drag and drop
-	// operations
-	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	if (Content)
 	{
-		d->ContentPreviewPixmap = QPixmap(Content->size());
-		Content->render(&d->ContentPreviewPixmap);
+		d->setContent(Content);
 	}
 
 	connect(qApp, SIGNAL(applicationStateChanged(Qt::ApplicationState)),
 		SLOT(onApplicationStateChanged(Qt::ApplicationState)));
-
-	// The only safe way to receive escape key presses is to install an event
-	// filter for the application object
-	qApp->installEventFilter(this);
 }
 
 
@@ -323,12 +476,7 @@ CFloatingDragPreview::CFloatingDragPreview(QWidget* Content, QWidget* parent) :
 CFloatingDragPreview::CFloatingDragPreview(CDockWidget* Content)
 	: CFloatingDragPreview((QWidget*)Content, Content->dockManager())
 {
-	d->DockManager = Content->dockManager();
-	if (Content->dockAreaWidget()->openDockWidgetsCount() == 1)
-	{
-		d->ContentSourceArea = Content->dockAreaWidget();
-	}
-	setWindowTitle(Content->windowTitle());
+
 }
 
 
@@ -336,9 +484,7 @@ CFloatingDragPreview::CFloatingDragPreview(CDockWidget* Content)
 CFloatingDragPreview::CFloatingDragPreview(CDockAreaWidget* Content)
 	: CFloatingDragPreview((QWidget*)Content, Content->dockManager())
 {
-	d->DockManager = Content->dockManager();
-	d->ContentSourceArea = Content;
-	setWindowTitle(Content->currentDockWidget()->windowTitle());
+
 }
 
 
@@ -349,6 +495,26 @@ CFloatingDragPreview::~CFloatingDragPreview()
 }
 
 
+//============================================================================
+CFloatingDragPreview* CFloatingDragPreview::create(CDockWidget* Content)
+{
+	auto Preview = Content->dockManager()->dragPreview();
+	disconnect(Preview, &CFloatingDragPreview::draggingCanceled, nullptr, nullptr);
+	Preview->d->setContent(Content);
+	return Preview;
+}
+
+
+//============================================================================
+CFloatingDragPreview* CFloatingDragPreview::create(CDockAreaWidget* Content)
+{
+	auto Preview = Content->dockManager()->dragPreview();
+	disconnect(Preview, &CFloatingDragPreview::draggingCanceled, nullptr, nullptr);
+	Preview->d->setContent(Content);
+	return Preview;
+}
+
+
 //============================================================================
 void CFloatingDragPreview::moveFloating()
 {
@@ -356,7 +522,7 @@ void CFloatingDragPreview::moveFloating()
 	const QPoint moveToPos = QCursor::pos() - d->DragStartMousePosition
 	    - QPoint(BorderSize, 0);
 	move(moveToPos);
-	d->updateDropOverlays(QCursor::pos());
+	d->DropOverlayUpdate.request();
 }
 
 
@@ -366,6 +532,10 @@ void CFloatingDragPreview::startFloating(const QPoint &DragStartMousePos,
 {
 	Q_UNUSED(MouseEventHandler)
 	Q_UNUSED(DragState)
+	d->Dragging = true;
+	// The only safe way to receive escape key presses is to install an event
+	// filter for the application object
+	qApp->installEventFilter(this);
 	resize(Size);
 	d->DragStartMousePosition = DragStartMousePos;
 	moveFloating();
@@ -378,6 +548,8 @@ void CFloatingDragPreview::startFloating(const QPoint &DragStartMousePos,
 void CFloatingDragPreview::finishDragging()
 {
 	ADS_PRINT("CFloatingDragPreview::finishDragging");
+	d->DropOverlayUpdate.flush();
+	d->releaseDragSnapshot();
 
 	auto DockDropArea = d->DockManager->dockAreaOverlay()->visibleDropAreaUnderCursor();
 	auto ContainerDropArea = d->DockManager->containerOverlay()->visibleDropAreaUnderCursor();
@@ -420,6 +592,7 @@ void CFloatingDragPreview::finishDragging()
 	this->close();
 	d->DockManager->containerOverlay()->hideOverlay();
 	d->DockManager->dockAreaOverlay()->hideOverlay();
+	d->endDragging();
 }
 
 
@@ -461,9 +634,11 @@ void CFloatingDragPreview::paintEvent(QPaintEvent* event)
 
 	QPainter painter(this);
 	painter.setOpacity(0.6);
-	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap)
+	 && !d->ContentPreviewPixmap.isNull())
 	{
-		painter.drawPixmap(QPoint(0, 0), d->ContentPreviewPixmap);
+		painter.setRenderHint(QPainter::SmoothPixmapTransform);
+		painter.drawPixmap(QRect(QPoint(0, 0), d->ContentPixmapSize), d->ContentPreviewPixmap);
 	}
 
 	// If we do not have a window frame then we paint a QRubberBand like
@@ -487,10 +662,8 @@ void CFloatingDragPreview::paintEvent(QPaintEvent* event)
 //============================================================================
 void CFloatingDragPreview::onApplicationStateChanged(Qt::ApplicationState state)
 {
-	if (state != Qt::ApplicationActive)
+	if (state != Qt::ApplicationActive && d->Dragging)
 	{
-		disconnect(qApp, SIGNAL(applicationStateChanged(Qt::ApplicationState)),
-			this, SLOT(onApplicationStateChanged(Qt::ApplicationState)));
 		d->cancelDragging();
 	}
 }
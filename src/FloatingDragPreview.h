@@ -31,6 +31,7 @@ class CFloatingDragPreview : public QWidget, public IFloatingWidget
 private:
 	FloatingDragPreviewPrivate* d;
 	friend struct FloatingDragPreviewPrivate;
+	friend class CDockManager;
 
 private Q_SLOTS:
 	/**
@@ -45,7 +46,9 @@ protected:
 	virtual void paintEvent(QPaintEvent *e) override;
 
 	/**
-	 * The content is a DockArea or a DockWidget
+	 * The content is a DockArea or a DockWidget. If Content is a nullptr,
+	 * the preview is created as reusable preview of the dock manager given
+	 * in parent - see create()
 	 */
 	CFloatingDragPreview(QWidget* Content, QWidget* parent);
 
@@ -68,6 +71,22 @@ public:
 	 */
 	~CFloatingDragPreview();
 
+	/**
+	 * Returns the reusable drag preview of the dock manager of the given
+	 * Content and prepares it for undocking Content.
+	 * Other than the constructors, this function does not create a new top
+	 * level window for each drag operation. All existing connections to the
+	 * draggingCanceled() signal are removed, so the caller needs to connect
+	 * to this signal again.
+	 */
+	static CFloatingDragPreview* create(CDockWidget* Content);
+
+	/**
+	 * Returns the reusable drag preview for undocking the DockArea given in
+	 * Content - see create(CDockWidget*)
+	 */
+	static CFloatingDragPreview* create(CDockAreaWidget* Content);
+
     /**
      * We filter the events of the assigned content widget to receive
      * escape key presses for canceling the drag operation
@@ -32,6 +32,14 @@
 #include <QPainter>
 #include <QAbstractButton>
 #include <QStyle>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+#include <QPointer>
+#include <QTimer>
+#include <QApplication>
+
+#include <algorithm>
 
 #include "DockSplitter.h"
 #include "DockManager.h"
@@ -450,6 +458,104 @@ void repolishStyle(QWidget* w, eRepolishChildOptions Options)
 }
 
 
+/**
+ * A pending scheduleRepolishStyle() request
+ */
+struct RepolishRequest
+{
+	QPointer<QWidget> Widget;
+	eRepolishChildOptions Options;
+};
+
+static QVector<RepolishRequest> RepolishQueue;
+
+
+/**
+ * Returns true, if the repolish of the given Request already includes
+ * the widget of the Other request
+ */
+static bool repolishRequestCovers(const RepolishRequest& Request, const RepolishRequest& Other)
+{
+	switch (Request.Options)
+	{
+	case RepolishChildrenRecursively:
+		 return Request.Widget->isAncestorOf(Other.Widget);
+
+	case RepolishDirectChildren:
+		 return (Other.Options == RepolishIgnoreChildren)
+			 && (Other.Widget->parentWidget() == Request.Widget);
+
+	default:
+		 return false;
+	}
+}
+
+
+/**
+ * Executes all pending repolish requests
+ */
+static void processRepolishQueue()
+{
+	// Take the queue, so that requests that are scheduled while polishing
+	// are executed in the next event loop cycle
+	QVector<RepolishRequest> Queue;
+	Queue.swap(RepolishQueue);
+	for (const auto& Request : Queue)
+	{
+		if (!Request.Widget)
+		{
+			continue;
+		}
+
+		bool Covered = false;
+		for (const auto& Other : Queue)
+		{
+			if (&Other != &Request && Other.Widget && repolishRequestCovers(Other, Request))
+			{
+				Covered = true;
+				break;
+			}
+		}
+
+		if (!Covered)
+		{
+			repolishStyle(Request.Widget, Request.Options);
+		}
+	}
+}
+
+
+//============================================================================
+void scheduleRepolishStyle(QWidget* w, eRepolishChildOptions Options)
+{
+	if (!w)
+	{
+		return;
+	}
+
+	for (auto& Request : RepolishQueue)
+	{
+		if (Request.Widget == w)
+		{
+			Request.Options = qMax(Request.Options, Options);
+			return;
+		}
+	}
+
+	if (RepolishQueue.isEmpty())
+	{
+		// Widget updates are posted with low priority, so a queued call
+		// with normal priority is executed before the next paint
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+		QMetaObject::invokeMethod(qApp, &processRepolishQueue, Qt::QueuedConnection);
+#else
+		QTimer::singleShot(0, &processRepolishQueue);
+#endif
+	}
+	RepolishQueue.append({w, Options});
+}
+
+
 //============================================================================
 QRect globalGeometry(QWidget* w)
 {
@@ -458,6 +564,136 @@ QRect globalGeometry(QWidget* w)
     return g;
 }
 
+
+//============================================================================
+void CTabExtents::reset(int Capacity)
+{
+	Extents.clear();
+	Extents.reserve(Capacity);
+	Valid = true;
+	Ordered = true;
+}
+
+
+//============================================================================
+void CTabExtents::append(int Index, int Start, int End)
+{
+	if (!Extents.isEmpty() && Start < Extents.last().End)
+	{
+		Ordered = false;
+	}
+	Extents.append({Start, End, Index});
+}
+
+
+//============================================================================
+int CTabExtents::indexAt(int Pos) const
+{
+	if (!Ordered)
+	{
+		for (const auto& Extent : Extents)
+		{
+			if (Pos >= Extent.Start && Pos < Extent.End)
+			{
+				return Extent.Index;
+			}
+		}
+		return -1;
+	}
+
+	auto it = std::upper_bound(Extents.begin(), Extents.end(), Pos,
+		[](int Value, const Extent& Extent)
+		{
+			return Value < Extent.Start;
+		});
+	if (it == Extents.begin())
+	{
+		return -1;
+	}
+	--it;
+	return (Pos < it->End) ? it->Index : -1;
+}
+
+
+//============================================================================
+int frameInterval(const QWidget* w)
+{
+	QScreen* Screen = nullptr;
+	auto Window = w ? w->window()->windowHandle() : nullptr;
+	if (Window)
+	{
+		Screen = Window->screen();
+	}
+	if (!Screen)
+	{
+		Screen = QGuiApplication::primaryScreen();
+	}
+
+	qreal RefreshRate = Screen ? Screen->refreshRate() : 0;
+	if (RefreshRate < 1)
+	{
+		RefreshRate = 60;
+	}
+	return qMax(1, qRound(1000.0 / RefreshRate));
+}
+
+
+//============================================================================
+CDragMoveCoalescer::CDragMoveCoalescer(const QWidget* Widget,
+	std::function<void()> Handler) :
+	Handler(Handler),
+	Widget(Widget)
+{
+	Timer.setSingleShot(true);
+	QObject::connect(&Timer, &QTimer::timeout, [this]()
+	{
+		if (!Pending)
+		{
+			return;
+		}
+
+		Pending = false;
+		Timer.start(frameInterval(this->Widget));
+		this->Handler();
+	});
+}
+
+
+//============================================================================
+void CDragMoveCoalescer::request()
+{
+	if (CDockManager::testConfigFlag(CDockManager::CoalesceDragMove))
+	{
+		if (Timer.isActive())
+		{
+			Pending = true;
+			return;
+		}
+		Timer.start(frameInterval(Widget));
+	}
+	Handler();
+}
+
+
+//============================================================================
+void CDragMoveCoalescer::flush()
+{
+	Timer.stop();
+	if (Pending)
+	{
+		Pending = false;
+		Handler();
+	}
+}
+
+
+//============================================================================
+void CDragMoveCoalescer::cancel()
+{
+	Timer.stop();
+	Pending = false;
+}
+
 } // namespace internal
 } // namespace ads
 
@@ -31,14 +31,17 @@
 //                                   INCLUDES
 //============================================================================
 #include <QPair>
+#include <QVector>
 #include <QtCore/QtGlobal>
 #include <QPixmap>
 #include <QWidget>
 #include <QDebug>
 #include <QStyle>
 #include <QMouseEvent>
+#include <QTimer>
 
 #include <iostream>
+#include <functional>
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
 #include <xcb/xcb.h>
@@ -163,10 +166,9 @@ Q_ENUMS(SideBarLocation)
 
 namespace internal
 {
-static const bool RestoreTesting = true;
-static const bool Restore = false;
 static const char* const ClosedProperty = "close";
 static const char* const DirtyProperty = "dirty";
+static const char* const UnchangedProperty = "unchanged";
 static const char* const LocationProperty = "Location";
 extern const int FloatingWidgetDragStartEvent;
 extern const int DockedWidgetDragStartEvent;
@@ -361,11 +363,124 @@ enum eRepolishChildOptions
 void repolishStyle(QWidget* w, eRepolishChildOptions Options = RepolishIgnoreChildren);
 
 
+/**
+ * Schedules a repolishStyle() call for the given widget.
+ * All requests of one event loop cycle are collected and executed in a
+ * single pass before the next paint. Multiple requests for the same widget
+ * are merged and requests for widgets that are already covered by the
+ * request of an ancestor are dropped. Use this function, if a style
+ * property may change several times in one event loop cycle.
+ */
+void scheduleRepolishStyle(QWidget* w, eRepolishChildOptions Options = RepolishIgnoreChildren);
+
+
 /**
  * Returns the geometry of the given widget in global space
  */
 QRect globalGeometry(QWidget* w);
 
+
+/**
+ * Cached start and end positions of the visible tabs of a tab bar along the
+ * tab bar orientation. The tab at a certain position is found with a binary
+ * search instead of querying the geometry of each tab widget.
+ * The owner is responsible for calling invalidate() if tabs are inserted,
+ * removed, moved or resized.
+ */
+class CTabExtents
+{
+private:
+	struct Extent
+	{
+		int Start;
+		int End;
+		int Index;
+	};
+	QVector<Extent> Extents;
+	bool Valid = false;
+	bool Ordered = true;
+
+public:
+	/**
+	 * Marks the extents as outdated
+	 */
+	void invalidate() {Valid = false;}
+
+	/**
+	 * Returns true, if the extents are up to date
+	 */
+	bool isValid() const {return Valid;}
+
+	/**
+	 * Removes all extents and marks the extents as valid. Call append()
+	 * for each visible tab afterwards.
+	 */
+	void reset(int Capacity = 0);
+
+	/**
+	 * Appends the extent of the tab with the given index. The range from
+	 * Start to End is half open. If the extents are not appended in ascending
+	 * order - e.g. while a tab is dragged - indexAt() falls back to a
+	 * linear search
+	 */
+	void append(int Index, int Start, int End);
+
+	/**
+	 * Returns the index of the tab whose extent contains the given position
+	 * or -1, if there is no such tab
+	 */
+	int indexAt(int Pos) const;
+};
+
+
+/**
+ * Returns the duration of one display frame in milliseconds for the screen
+ * of the given widget. If the refresh rate is unknown, 60 Hz is assumed.
+ */
+int frameInterval(const QWidget* w);
+
+
+/**
+ * Coalesces the processing of drag moves to at most one call per display
+ * frame, if the CoalesceDragMove config flag is set. The first request of
+ * a frame calls the handler immediately and further requests within the
+ * same frame are merged into one call at the end of the frame. The handler
+ * reads the cursor position when it is called, so a merged call always
+ * uses the latest position. If the flag is not set, each request calls the
+ * handler immediately.
+ */
+class CDragMoveCoalescer
+{
+private:
+	QTimer Timer;
+	std::function<void()> Handler;
+	const QWidget* Widget;
+	bool Pending = false;
+
+public:
+	/**
+	 * Creates a coalescer that calls the given Handler. The duration of a
+	 * frame is taken from the screen of the given Widget.
+	 */
+	CDragMoveCoalescer(const QWidget* Widget, std::function<void()> Handler);
+
+	/**
+	 * Calls the handler immediately or at the end of the current frame
+	 */
+	void request();
+
+	/**
+	 * Calls the handler immediately, if a call is pending. This is required
+	 * before the drop target is evaluated.
+	 */
+	void flush();
+
+	/**
+	 * Discards a pending call - e.g. if dragging has been canceled
+	 */
+	void cancel();
+};
+
 } // namespace internal
 } // namespace ads
 
@@ -220,7 +220,7 @@ void CFloatingWidgetTitleBar::setTitle(const QString &Text)
 //============================================================================
 void CFloatingWidgetTitleBar::updateStyle()
 {
-    internal::repolishStyle(this, internal::RepolishDirectChildren);
+    internal::scheduleRepolishStyle(this, internal::RepolishDirectChildren);
 }
 
 
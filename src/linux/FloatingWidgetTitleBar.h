@@ -85,7 +85,8 @@ public:
 	void setTitle(const QString &Text);
 
     /**
-     * Update stylesheet style if a property changes
+     * Update stylesheet style if a property changes.
+     * The update is deferred and executed once before the next paint
      */
     void updateStyle();
 
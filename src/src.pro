@@ -15,6 +15,14 @@ adsBuildStatic {
 	CONFIG += staticlib
     DEFINES += ADS_STATIC
 }
+adsWithZstd {
+    DEFINES += ADS_HAS_ZSTD
+    LIBS += -lzstd
+}
+adsWithLz4 {
+    DEFINES += ADS_HAS_LZ4
+    LIBS += -llz4
+}
 
 windows {
 	# MinGW
@@ -37,7 +45,10 @@ HEADERS += \
     DockManager.h \
     DockWidget.h \
     DockWidgetTab.h \ 
+    DockingState.h \
     DockingStateReader.h \
+    DockPerspectiveStore.h \
+    DockDragSnapshot.h \
     FloatingDockContainer.h \
     FloatingDragPreview.h \
     DockOverlay.h \
@@ -62,7 +73,10 @@ SOURCES += \
     DockContainerWidget.cpp \
     DockManager.cpp \
     DockWidget.cpp \
+    DockingState.cpp \
     DockingStateReader.cpp \
+    DockPerspectiveStore.cpp \
+    DockDragSnapshot.cpp \
     DockWidgetTab.cpp \
     FloatingDockContainer.cpp \
     FloatingDragPreview.cpp \